@@ -0,0 +1,739 @@
+/*
+ * Intelligent SNAKE: Engine Check
+ *
+ *   Description: A headless harness that plays random games through the
+ *                original sprite-scanning game logic and the board engines
+ *                side by side, comparing them after every tick
+ *
+ * This project is licensed under the the MIT License (MIT): see isnake.c
+ *
+ * Usage:
+ *   check [seeds] [ticks]   Play a game for each seed, steering away from walls
+ *   check -r [seed] [input] Replay one game, where each input character is a
+ *                           key press (U, D, L or R) or a scroll (.)
+ *
+ * Building with -DISNAKE_FUZZ swaps main() for a libFuzzer entry point.
+ *
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// HEADLESS STAND-INS FOR THE PARTS OF SDL THE GAME USES
+#define ISNAKE_HEADLESS
+
+typedef uint8_t Uint8;
+typedef uint16_t Uint16;
+typedef int16_t Sint16;
+typedef uint32_t Uint32;
+
+typedef struct { Sint16 x, y; Uint16 w, h; } SDL_Rect;
+typedef struct { Uint8 r, g, b, unused; } SDL_Colour;
+typedef struct { int unused; } SDL_PixelFormat;
+typedef struct { SDL_PixelFormat* format; } SDL_Surface;
+typedef struct { int type; struct { struct { int sym; } keysym; } key; } SDL_Event;
+typedef struct { int unused; } TTF_Font;
+
+enum { SDL_QUIT = 1, SDL_KEYDOWN, SDL_MOUSEMOTION, SDL_IGNORE };
+enum { SDLK_UP = 1, SDLK_DOWN, SDLK_LEFT, SDLK_RIGHT, SDLK_w, SDLK_a, SDLK_s, SDLK_d, SDLK_h, SDLK_j, SDLK_k, SDLK_l, SDLK_q, SDLK_ESCAPE, SDLK_SPACE, SDLK_RETURN };
+
+#define SDL_INIT_VIDEO 0
+#define SDL_INIT_TIMER 0
+#define SDL_HWSURFACE 0
+#define SDL_DOUBLEBUF 0
+#define SDL_ANYFORMAT 0
+
+// THE KEY THE HARNESS PRESSES ON THE NEXT POLL (0 FOR NONE)
+static int pendingKey = 0;
+
+static int SDL_Init(Uint32 flags) { return 0; }
+static void SDL_Quit(void) { }
+static char* SDL_GetError(void) { return "headless"; }
+static SDL_Surface* SDL_SetVideoMode(int width, int height, int bpp, Uint32 flags) { return NULL; }
+static Uint8 SDL_EventState(Uint8 type, int state) { return 0; }
+static void SDL_WM_SetCaption(const char* title, const char* icon) { }
+static int SDL_FillRect(SDL_Surface* surface, SDL_Rect* rect, Uint32 colour) { return 0; }
+static Uint32 SDL_MapRGB(SDL_PixelFormat* format, Uint8 r, Uint8 g, Uint8 b) { return 0; }
+static int SDL_Flip(SDL_Surface* surface) { return 0; }
+static void SDL_Delay(Uint32 ms) { }
+static void SDL_FreeSurface(SDL_Surface* surface) { }
+static int SDL_BlitSurface(SDL_Surface* source, SDL_Rect* sourceRect, SDL_Surface* destination, SDL_Rect* destinationRect) { return 0; }
+static int TTF_Init(void) { return 0; }
+static void TTF_Quit(void) { }
+static TTF_Font* TTF_OpenFont(const char* file, int size) { return NULL; }
+static void TTF_CloseFont(TTF_Font* font) { }
+static SDL_Surface* TTF_RenderText_Shaded(TTF_Font* font, const char* text, SDL_Colour foreground, SDL_Colour background) { return NULL; }
+
+static int SDL_PollEvent(SDL_Event* event) {
+    if (pendingKey == 0) {
+        return 0;
+    }
+
+    (*event).type = SDL_KEYDOWN;
+    (*event).key.keysym.sym = pendingKey;
+    pendingKey = 0;
+    return 1;
+}
+
+// THE GAME ITSELF, WITH ITS main() MOVED OUT OF THE WAY
+#define main isnakeMain
+#include "isnake.c"
+#undef main
+
+// DEFAULT NUMBER OF GAMES AND THE LONGEST EACH ONE CAN RUN
+#define DEFAULT_SEEDS 200
+#define DEFAULT_TICKS 1500
+#define MAX_INPUTS 4096
+
+// TICKS BETWEEN CHECKS OF FOOD PLACEMENT WHILE PART OF THE GRID IS SEALED OFF
+#define PROBE_TICKS 8
+
+// LONGEST DESCRIPTION OF A DIVERGENCE
+#define MAX_MESSAGE 256
+
+// MOST SPRITES A GAME CAN HAVE
+#define MAX_SPRITES (MAX_FOODCOUNT + MAX_LEVELBLOCKS + MAX_SNAKELENGTH)
+
+// INPUT CHARACTERS: A KEY PRESS FOR EACH DIRECTION, THEN LETTING THE SNAKE SCROLL
+static const char inputKeys[] = "UDLR.";
+static const int inputSyms[4] = { SDLK_UP, SDLK_DOWN, SDLK_LEFT, SDLK_RIGHT };
+
+// GRID SIZES A GAME CAN BE PLAYED ON: EVERY SPECIALIZED ENGINE PLUS SOME THAT FALL BACK TO THE GENERIC ONE
+static const int caseGrids[][2] = { { 50, 30 }, { 80, 50 }, { 32, 32 }, { 64, 32 }, { 30, 20 }, { 47, 23 } };
+
+// ROW AND COLUMN OFFSETS OF EACH DIRECTION, KEPT APART FROM THE GAME'S OWN TABLE
+static const int referenceOffset[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+// THE REFERENCE GAME: THE ORIGINAL LOGIC RUNNING ON ITS OWN COPY OF THE RULES AND STATE
+struct referenceGame {
+    struct gameRules rules;
+    int gameParameters[9];
+    int sprites[MAX_SPRITES][2];
+};
+
+// A SMALL RANDOM NUMBER GENERATOR FOR PICKING SETTINGS AND INPUT, KEPT APART FROM THE GAME'S rand()
+static uint32_t nextRandom(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// THE ORIGINAL collisionDetect: SCAN EVERY SPRITE UP TO THE TAIL, THEN CHECK THE WALLS
+static enum collision referenceCollision(struct referenceGame* game, enum direction newDirection, int* food) {
+    int x, nextRow, nextColumn;
+    int* gameParameters = game->gameParameters;
+    int* head = game->sprites[gameParameters[NPCCount]];
+
+    nextRow = head[0];
+    nextColumn = head[1];
+
+    switch (newDirection) {
+        case Up:
+            nextRow = head[0] - 1;
+            break;
+
+        case Down:
+            nextRow = head[0] + 1;
+            break;
+
+        case Left:
+            nextColumn = head[1] - 1;
+            break;
+
+        case Right:
+            nextColumn = head[1] + 1;
+            break;
+    }
+
+    if (game->rules.wrapWalls) {
+        nextRow = (nextRow + gameParameters[TilesHigh]) % gameParameters[TilesHigh];
+        nextColumn = (nextColumn + gameParameters[TilesWide]) % gameParameters[TilesWide];
+    }
+
+    for (x = 0; x < gameParameters[NPCCount] + gameParameters[SnakeLength] - 2; ++x) {
+        if ((nextRow == game->sprites[x][0]) && (nextColumn == game->sprites[x][1])) {
+            if (x < game->rules.foodCount) {
+                *food = x;
+                return CollisionFood;
+            }
+
+            return CollisionFatal;
+        }
+    }
+
+    if ((nextRow < 0) || (nextRow >= gameParameters[TilesHigh]) || (nextColumn < 0) || (nextColumn >= gameParameters[TilesWide])) {
+        return CollisionFatal;
+    }
+
+    return CollisionNone;
+}
+
+// THE ORIGINAL INPUT HANDLING: WHICH WAY AN INPUT MOVES THE SNAKE, OR -1 IF IT DOESN'T
+static int referenceDirection(int currentDirection, char input) {
+    switch (input) {
+        case 'U':
+            return (((currentDirection != Up) && (currentDirection != Down)) ? Up : -1);
+
+        case 'D':
+            return (((currentDirection != Down) && (currentDirection != Up)) ? Down : -1);
+
+        case 'L':
+            return (((currentDirection != Left) && (currentDirection != Right) && (currentDirection != -1)) ? Left : -1);
+
+        case 'R':
+            return (((currentDirection != Right) && (currentDirection != Left)) ? Right : -1);
+
+        default:
+            return currentDirection;
+    }
+}
+
+// FLOODS THE FREE TILES AROUND THE REFERENCE SNAKE'S HEAD, RETURNING HOW MANY IT REACHED
+static int referenceFlood(struct referenceGame* game, bool seen[MAX_TILES]) {
+    int x, tile, row, column, head = 0, tail = 0, queue[MAX_TILES];
+    int* gameParameters = game->gameParameters;
+    bool occupied[MAX_TILES];
+
+    for (tile = 0; tile < MAX_TILES; tile++) {
+        occupied[tile] = false;
+        seen[tile] = false;
+    }
+
+    for (x = game->rules.foodCount; x < gameParameters[NPCCount] + gameParameters[SnakeLength] - 1; x++) {
+        occupied[(game->sprites[x][0] * gameParameters[TilesWide]) + game->sprites[x][1]] = true;
+    }
+
+    queue[tail++] = -1;
+
+    while (head < tail) {
+        tile = queue[head++];
+
+        for (x = Up; x <= Right; x++) {
+            // THE FIRST ENTRY STANDS FOR THE SNAKE'S HEAD, WHICH IS OCCUPIED BUT STILL FLOODS OUTWARDS
+            row = ((tile == -1) ? game->sprites[gameParameters[NPCCount]][0] : tile / gameParameters[TilesWide]) + referenceOffset[x][0];
+            column = ((tile == -1) ? game->sprites[gameParameters[NPCCount]][1] : tile % gameParameters[TilesWide]) + referenceOffset[x][1];
+
+            if (game->rules.wrapWalls) {
+                row = (row + gameParameters[TilesHigh]) % gameParameters[TilesHigh];
+                column = (column + gameParameters[TilesWide]) % gameParameters[TilesWide];
+            } else if ((row < 0) || (row >= gameParameters[TilesHigh]) || (column < 0) || (column >= gameParameters[TilesWide])) {
+                continue;
+            }
+
+            if (!occupied[(row * gameParameters[TilesWide]) + column] && !seen[(row * gameParameters[TilesWide]) + column]) {
+                seen[(row * gameParameters[TilesWide]) + column] = true;
+                queue[tail++] = (row * gameParameters[TilesWide]) + column;
+            }
+        }
+    }
+
+    return tail - 1;
+}
+
+// WHETHER THE FLOOD REACHED A TILE, OR (FOR AN OCCUPIED ONE) A TILE NEXT TO IT
+static bool referenceReaches(struct referenceGame* game, bool seen[MAX_TILES], int position[2]) {
+    int x, row, column;
+    int* gameParameters = game->gameParameters;
+    int* head = game->sprites[gameParameters[NPCCount]];
+
+    for (x = -1; x <= Right; x++) {
+        row = position[0] + ((x == -1) ? 0 : referenceOffset[x][0]);
+        column = position[1] + ((x == -1) ? 0 : referenceOffset[x][1]);
+
+        if (game->rules.wrapWalls) {
+            row = (row + gameParameters[TilesHigh]) % gameParameters[TilesHigh];
+            column = (column + gameParameters[TilesWide]) % gameParameters[TilesWide];
+        } else if ((row < 0) || (row >= gameParameters[TilesHigh]) || (column < 0) || (column >= gameParameters[TilesWide])) {
+            continue;
+        }
+
+        // NEXT TO THE HEAD, OR ON (OR NEXT TO) A FLOODED TILE
+        if (((x != -1) && (row == head[0]) && (column == head[1])) || seen[(row * gameParameters[TilesWide]) + column]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// WHETHER THE FLOOD REACHED A TILE FOOD IS ALLOWED ON: OFF THE OUTERMOST ROWS AND COLUMNS, NOT ON A SPRITE
+// AND NOT RIGHT NEXT TO THE HEAD
+static bool referenceRoom(struct referenceGame* game, bool seen[MAX_TILES]) {
+    int x, tile, row, column;
+    int* gameParameters = game->gameParameters;
+    int* head = game->sprites[gameParameters[NPCCount]];
+
+    for (tile = 0; tile < gameParameters[TilesWide] * gameParameters[TilesHigh]; tile++) {
+        row = tile / gameParameters[TilesWide];
+        column = tile % gameParameters[TilesWide];
+
+        if (!seen[tile] || (row == 0) || (row == gameParameters[TilesHigh] - 1) || (column == 0) || (column == gameParameters[TilesWide] - 1) || ((abs(row - head[0]) + abs(column - head[1])) == 1)) {
+            continue;
+        }
+
+        for (x = 0; (x < gameParameters[NPCCount] + gameParameters[SnakeLength]) && ((game->sprites[x][0] != row) || (game->sprites[x][1] != column)); x++);
+
+        if (x == gameParameters[NPCCount] + gameParameters[SnakeLength]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// THE ORIGINAL MOVEMENT AND FEEDING, RUN AFTER THE GAME'S TICK: NEW FOOD GOES WHERE THE GAME PUT IT SINCE
+// PLACEMENT IS RANDOM, AND misplaced IS SET TO THE FOOD IF IT WENT OUT OF REACH WHEN IT DIDN'T HAVE TO
+static bool referenceStep(struct referenceGame* game, enum direction newDirection, int** ppSprites, int* misplaced) {
+    bool seen[MAX_TILES], hasRoom;
+    int x, y, food = 0, tail;
+    int* gameParameters = game->gameParameters;
+    enum collision result = referenceCollision(game, newDirection, &food);
+
+    if (result == CollisionFatal) {
+        return false;
+    }
+
+    if (result == CollisionFood) {
+        for (x = 0; (x < game->rules.growthPerFood) && (gameParameters[SnakeLength] < MAX_SNAKELENGTH); x++) {
+            gameParameters[SnakeLength]++;
+            tail = gameParameters[NPCCount] + gameParameters[SnakeLength] - 2;
+
+            if (x > 0) {
+                game->sprites[tail][0] = game->sprites[tail - 1][0];
+                game->sprites[tail][1] = game->sprites[tail - 1][1];
+            }
+        }
+
+        if ((game->rules.accelFreq != 0) && ((gameParameters[SnakeScore] % game->rules.accelFreq) == 0) && (gameParameters[SnakeScore] != 0) && (gameParameters[SnakeSpeed] < MAX_SNAKESPEED)) {
+            gameParameters[SnakeSpeed]++;
+        }
+
+        gameParameters[SnakeScore]++;
+
+        // THE GAME PLACES FOOD HERE, AFTER GROWING BUT BEFORE MOVING, SO JUDGE ITS FAIRNESS FROM THIS STATE
+        referenceFlood(game, seen);
+        hasRoom = referenceRoom(game, seen);
+        game->sprites[food][0] = ppSprites[food][0];
+        game->sprites[food][1] = ppSprites[food][1];
+
+        if (hasRoom && !referenceReaches(game, seen, game->sprites[food])) {
+            *misplaced = food;
+        }
+    }
+
+    for (x = gameParameters[NPCCount] + gameParameters[SnakeLength] - 1; x > gameParameters[NPCCount]; x--) {
+        for (y = 0; y < 2; y++) {
+            game->sprites[x][y] = game->sprites[x - 1][y];
+        }
+    }
+
+    x = gameParameters[NPCCount];
+
+    switch (newDirection) {
+        case Up:
+            game->sprites[x][0]--;
+            break;
+
+        case Down:
+            game->sprites[x][0]++;
+            break;
+
+        case Left:
+            game->sprites[x][1]--;
+            break;
+
+        case Right:
+            game->sprites[x][1]++;
+            break;
+    }
+
+    if (game->rules.wrapWalls) {
+        game->sprites[x][0] = (game->sprites[x][0] + gameParameters[TilesHigh]) % gameParameters[TilesHigh];
+        game->sprites[x][1] = (game->sprites[x][1] + gameParameters[TilesWide]) % gameParameters[TilesWide];
+    }
+
+    gameParameters[SnakeDirection] = newDirection;
+    return true;
+}
+
+// COMPARES EVERY ENGINE'S VERDICT IN EVERY DIRECTION AGAINST THE ORIGINAL LOGIC
+static bool compareEngines(struct referenceGame* game, int** ppSprites, int (*gameParameters)[9], char* message) {
+    collisionEngine engines[2] = { activeEngine, (game->rules.wrapWalls ? collisionEngineGenericWrap : collisionEngineGeneric) };
+    const char* engineNames[2] = { "selected", "generic" };
+    enum collision expected, actual;
+    int x, direction, expectedFood = -1, actualFood = -1, next[2];
+
+    for (direction = Up; direction <= Right; direction++) {
+        expected = referenceCollision(game, direction, &expectedFood);
+
+        for (x = 0; x < 2; x++) {
+            actual = engines[x](ppSprites, gameParameters, direction, &actualFood, next);
+
+            if ((actual != expected) || ((expected == CollisionFood) && (actualFood != expectedFood))) {
+                sprintf(message, "%s engine says %d (food %d) moving %c, original logic says %d (food %d)", engineNames[x], actual, actualFood, inputKeys[direction], expected, expectedFood);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// COMPARES THE GAME'S STATE AND REACHABILITY AGAINST THE REFERENCE GAME
+static bool compareState(struct referenceGame* game, int** ppSprites, int (*gameParameters)[9], bool ate, bool probe, char* message) {
+    bool seen[MAX_TILES];
+    int x, y, tile, area, freeTiles = 0, occupants[MAX_TILES], location[2];
+    int* pLocation[2] = { location, location };
+
+    for (x = 0; x < 9; x++) {
+        if ((*gameParameters)[x] != game->gameParameters[x]) {
+            sprintf(message, "game parameter %d is %d, original logic has %d", x, (*gameParameters)[x], game->gameParameters[x]);
+            return false;
+        }
+    }
+
+    for (x = 0; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength]; x++) {
+        if ((ppSprites[x][0] != game->sprites[x][0]) || (ppSprites[x][1] != game->sprites[x][1])) {
+            sprintf(message, "sprite %d is at %d,%d, original logic has %d,%d", x, ppSprites[x][0], ppSprites[x][1], game->sprites[x][0], game->sprites[x][1]);
+            return false;
+        }
+    }
+
+    // FOOD NEVER LANDS ON ANOTHER SPRITE
+    for (x = 0; ate && (x < game->rules.foodCount); x++) {
+        for (y = 0; y < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 1; y++) {
+            if ((x != y) && (ppSprites[x][0] == ppSprites[y][0]) && (ppSprites[x][1] == ppSprites[y][1])) {
+                sprintf(message, "food %d was placed on sprite %d", x, y);
+                return false;
+            }
+        }
+    }
+
+    // THE OCCUPANCY GRID MATCHES A RECOUNT OF THE SPRITES
+    for (tile = 0; tile < (*gameParameters)[TilesWide] * (*gameParameters)[TilesHigh]; tile++) {
+        occupants[tile] = 0;
+    }
+
+    for (x = game->rules.foodCount; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 1; x++) {
+        occupants[(ppSprites[x][0] * (*gameParameters)[TilesWide]) + ppSprites[x][1]]++;
+    }
+
+    for (tile = 0; tile < (*gameParameters)[TilesWide] * (*gameParameters)[TilesHigh]; tile++) {
+        freeTiles += (occupants[tile] == 0);
+
+        if (reach.occupants[tile] != occupants[tile]) {
+            sprintf(message, "tile %d,%d has %d occupants, recount has %d", tile / (*gameParameters)[TilesWide], tile % (*gameParameters)[TilesWide], reach.occupants[tile], occupants[tile]);
+            return false;
+        }
+    }
+
+    // THE INCREMENTAL REACHABILITY MATCHES A FULL FLOOD FILL
+    area = referenceFlood(game, seen);
+
+    if (reachAreaFromHead(ppSprites, gameParameters) != area) {
+        sprintf(message, "reachable area is %d, flood fill has %d", reachAreaFromHead(ppSprites, gameParameters), area);
+        return false;
+    }
+
+    for (x = 0; x < game->rules.foodCount; x++) {
+        if (reachFromHead(ppSprites, gameParameters, ppSprites[x]) != referenceReaches(game, seen, game->sprites[x])) {
+            sprintf(message, "food %d reachability disagrees with the flood fill", x);
+            return false;
+        }
+    }
+
+    x = (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2;
+
+    if (reachFromHead(ppSprites, gameParameters, ppSprites[x]) != referenceReaches(game, seen, game->sprites[x])) {
+        sprintf(message, "tail reachability disagrees with the flood fill");
+        return false;
+    }
+
+    // WHILE PART OF THE GRID IS SEALED OFF, PLACING FOOD MUST STILL PICK A TILE IN REACH WHEN THERE IS ONE
+    if (probe && (area < freeTiles) && referenceRoom(game, seen)) {
+        randomLocation(ppSprites, gameParameters, pLocation, true);
+
+        if (!referenceReaches(game, seen, location)) {
+            sprintf(message, "food placement picked %d,%d out of reach while there was room in reach", location[0], location[1]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// PICKS AN INPUT THAT KEEPS THE REFERENCE SNAKE ALIVE WHEN ONE EXISTS, MOSTLY ONE HEADING FOR THE NEAREST FOOD IT CAN
+// GET TO, SO GAMES GROW LONG SNAKES THAT KEEP EATING AFTER SEALING THEMSELVES INTO PART OF THE GRID
+static char steerInput(struct referenceGame* game, uint32_t* state) {
+    bool seen[MAX_TILES], reachable[MAX_FOODCOUNT];
+    int x, y, direction, food, row, column, distance, bestDistance = -1, first = nextRandom(state) % 5;
+    int* head = game->sprites[game->gameParameters[NPCCount]];
+    bool chase = ((nextRandom(state) % 4) != 0);
+    char input, best = inputKeys[first];
+
+    referenceFlood(game, seen);
+
+    for (y = 0; y < game->rules.foodCount; y++) {
+        reachable[y] = referenceReaches(game, seen, game->sprites[y]);
+    }
+
+    for (x = 0; x < 5; x++) {
+        input = inputKeys[(first + x) % 5];
+        direction = referenceDirection(game->gameParameters[SnakeDirection], input);
+
+        if ((direction != -1) && (referenceCollision(game, direction, &food) == CollisionFatal)) {
+            continue;
+        }
+
+        if (!chase) {
+            return input;
+        }
+
+        // HOW FAR THE HEAD ENDS UP FROM THE NEAREST REACHABLE FOOD (IGNORING WRAPPED WALLS)
+        row = head[0] + ((direction == -1) ? 0 : referenceOffset[direction][0]);
+        column = head[1] + ((direction == -1) ? 0 : referenceOffset[direction][1]);
+
+        for (y = 0; y < game->rules.foodCount; y++) {
+            if (!reachable[y]) {
+                continue;
+            }
+
+            distance = abs(row - game->sprites[y][0]) + abs(column - game->sprites[y][1]);
+
+            if ((bestDistance == -1) || (distance < bestDistance)) {
+                best = input;
+                bestDistance = distance;
+            }
+        }
+    }
+
+    return best;
+}
+
+// PLAYS A GAME FROM A SEED, FILLING IN STEERED INPUT WHEN ASKED; RETURNS THE TICK IT DIVERGED ON, 0 IF IT MATCHED, OR -1 IF THE LEVEL COULDN'T BE MADE
+static int runCase(uint32_t seed, char* inputs, int length, bool steer, char* message) {
+    static SDL_Rect tileRows[MAX_TILESHIGH][MAX_TILESWIDE];
+    static SDL_PixelFormat format;
+    static struct referenceGame game;
+    SDL_Rect* ppTiles[MAX_TILESHIGH];
+    SDL_Surface screen = { &format };
+    SDL_Event event;
+    uint32_t state = (seed * 2654435761u) | 1;
+    int x, tick, direction, score, misplaced, gameParameters[9], blocks, grid, diverged = 0, spriteCount;
+    int** ppSprites;
+    bool alive = true, expectAlive;
+    char scratch[MAX_MESSAGE];
+
+    if (message == NULL) {
+        message = scratch;
+    }
+
+    for (x = 0; x < MAX_TILESHIGH; x++) {
+        ppTiles[x] = tileRows[x];
+    }
+
+    // PICK THE RULES AND SETTINGS FROM THE SEED, GIVING THE GAME AND THE REFERENCE EACH THEIR OWN COPY OF THE RULES
+    grid = nextRandom(&state) % (sizeof(caseGrids) / sizeof(caseGrids[0]));
+    game.rules.wrapWalls = (nextRandom(&state) % 2 == 0);
+    game.rules.growthPerFood = nextRandom(&state) % 4;
+    game.rules.accelFreq = nextRandom(&state) % 5;
+    game.rules.foodCount = MIN_FOODCOUNT + (nextRandom(&state) % MAX_FOODCOUNT);
+    game.rules.blockPattern = nextRandom(&state) % 4;
+    rules = game.rules;
+    blocks = nextRandom(&state) % MAX_NPCCOUNT;
+
+    gameParameters[QuitGame] = 0;
+    gameParameters[TilesWide] = caseGrids[grid][0];
+    gameParameters[TilesHigh] = caseGrids[grid][1];
+    gameParameters[SnakeSpeed] = DEFAULT_SNAKESPEED;
+    gameParameters[SnakeLength] = DEFAULT_SNAKELENGTH + (nextRandom(&state) % 8);
+    gameParameters[SnakeDirection] = -1;
+    gameParameters[SnakeScore] = 0;
+    gameParameters[RenderSizeMultiplier] = 1;
+
+    // LAY OUT THE GAME THE SAME WAY main() DOES
+    srand(seed);
+
+    if (!generateLevel(&currentLevel, gameParameters[TilesWide], gameParameters[TilesHigh], blocks)) {
+        sprintf(message, "level generation failed for seed %u", seed);
+        return -1;
+    }
+
+    gameParameters[NPCCount] = rules.foodCount + currentLevel.blockCount;
+    spriteCount = gameParameters[NPCCount] + MAX_SNAKELENGTH;
+    ppSprites = malloc(spriteCount * sizeof(int*));
+
+    for (x = 0; x < spriteCount; x++) {
+        ppSprites[x] = calloc(2, sizeof(int));
+    }
+
+    placeSprites(ppSprites, &gameParameters);
+    activeEngine = selectBoardEngine(&gameParameters);
+
+    memcpy(game.gameParameters, gameParameters, sizeof(gameParameters));
+
+    for (x = 0; x < spriteCount; x++) {
+        game.sprites[x][0] = ppSprites[x][0];
+        game.sprites[x][1] = ppSprites[x][1];
+    }
+
+    for (tick = 0; (tick < length) && alive && (diverged == 0); tick++) {
+        if (steer) {
+            inputs[tick] = steerInput(&game, &state);
+        }
+
+        if (!compareEngines(&game, ppSprites, &gameParameters, message)) {
+            diverged = tick + 1;
+            break;
+        }
+
+        // THE GAME TAKES THE INPUT THROUGH ITS OWN EVENT HANDLING
+        if (inputs[tick] == '.') {
+            alive = scrollSnake(&screen, ppTiles, ppSprites, &gameParameters);
+        } else {
+            pendingKey = inputSyms[strchr(inputKeys, inputs[tick]) - inputKeys];
+            alive = gameEventPoll(&screen, ppTiles, ppSprites, &gameParameters, &event);
+        }
+
+        // THEN THE ORIGINAL LOGIC DECIDES WHETHER THE INPUT MOVES THE SNAKE AND WHETHER IT SURVIVES
+        direction = referenceDirection(game.gameParameters[SnakeDirection], inputs[tick]);
+        score = game.gameParameters[SnakeScore];
+        misplaced = -1;
+        expectAlive = ((direction == -1) || referenceStep(&game, direction, ppSprites, &misplaced));
+
+        if (alive != expectAlive) {
+            sprintf(message, "the game says the snake %s, original logic says it %s", alive ? "lived" : "died", expectAlive ? "lived" : "died");
+            diverged = tick + 1;
+        } else if (misplaced != -1) {
+            sprintf(message, "food %d was placed out of reach while there was room for it in reach", misplaced);
+            diverged = tick + 1;
+        } else if (alive && !compareState(&game, ppSprites, &gameParameters, (game.gameParameters[SnakeScore] != score), ((tick % PROBE_TICKS) == 0), message)) {
+            diverged = tick + 1;
+        }
+    }
+
+    for (x = 0; x < spriteCount; x++) {
+        free(ppSprites[x]);
+    }
+
+    free(ppSprites);
+    return diverged;
+}
+
+// SHRINKS A DIVERGING INPUT STREAM BY DROPPING EVER SMALLER CHUNKS THAT AREN'T NEEDED TO REPRODUCE IT
+static int shrinkCase(uint32_t seed, char* inputs, int length) {
+    char candidate[MAX_INPUTS];
+    int chunk, start, tick;
+
+    length = runCase(seed, inputs, length, false, NULL);
+
+    for (chunk = length / 2; chunk >= 1; chunk /= 2) {
+        for (start = 0; start + chunk <= length;) {
+            memcpy(candidate, inputs, start);
+            memcpy(candidate + start, inputs + start + chunk, length - start - chunk);
+
+            if ((tick = runCase(seed, candidate, length - chunk, false, NULL)) > 0) {
+                memcpy(inputs, candidate, tick);
+                length = tick;
+            } else {
+                start += chunk;
+            }
+        }
+    }
+
+    return length;
+}
+
+#ifdef ISNAKE_FUZZ
+
+// LIBFUZZER ENTRY POINT: THE FIRST FOUR BYTES ARE THE SEED, EACH BYTE AFTER THAT IS AN INPUT
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    char inputs[MAX_INPUTS], message[MAX_MESSAGE];
+    uint32_t seed;
+    int x, length;
+
+    if (size < 4) {
+        return 0;
+    }
+
+    seed = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+    length = ((size - 4) < MAX_INPUTS) ? (size - 4) : MAX_INPUTS;
+
+    for (x = 0; x < length; x++) {
+        inputs[x] = inputKeys[data[4 + x] % 5];
+    }
+
+    if (runCase(seed, inputs, length, false, message) != 0) {
+        fprintf(stderr, "check: seed %u diverged: %s\n", seed, message);
+        abort();
+    }
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char* args[]) {
+    char inputs[MAX_INPUTS + 1], message[MAX_MESSAGE];
+    int seeds = DEFAULT_SEEDS, ticks = DEFAULT_TICKS, length, tick;
+    uint32_t seed;
+
+    // REPLAY A SINGLE GAME
+    if ((argc == 4) && (strcmp(args[1], "-r") == 0)) {
+        seed = strtoul(args[2], NULL, 10);
+        length = strlen(args[3]);
+
+        if ((length > MAX_INPUTS) || (strspn(args[3], inputKeys) != (size_t)length)) {
+            fprintf(stderr, "  Error: input must be at most %d of the characters %s\n", MAX_INPUTS, inputKeys);
+            exit(EXIT_FAILURE);
+        }
+
+        memcpy(inputs, args[3], length);
+
+        if ((tick = runCase(seed, inputs, length, false, message)) < 0) {
+            fprintf(stdout, "check: %s\n", message);
+            exit(EXIT_FAILURE);
+        } else if (tick > 0) {
+            fprintf(stdout, "check: seed %u diverged at tick %d: %s\n", seed, tick, message);
+            exit(EXIT_FAILURE);
+        }
+
+        fprintf(stdout, "check: seed %u matched the original logic\n", seed);
+        exit(EXIT_SUCCESS);
+    }
+
+    if (argc > 1) {
+        seeds = atoi(args[1]);
+    }
+
+    if (argc > 2) {
+        ticks = atoi(args[2]);
+    }
+
+    if ((argc > 3) || (seeds < 1) || (ticks < 1) || (ticks > MAX_INPUTS)) {
+        fprintf(stderr, "  Usage: %s [seeds] [ticks (max %d)]\n         %s -r [seed] [input]\n", args[0], MAX_INPUTS, args[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    for (seed = 1; seed <= (uint32_t)seeds; seed++) {
+        if ((tick = runCase(seed, inputs, ticks, true, message)) < 0) {
+            fprintf(stdout, "check: %s\n", message);
+            exit(EXIT_FAILURE);
+        } else if (tick > 0) {
+            fprintf(stdout, "check: seed %u diverged at tick %d: %s\n", seed, tick, message);
+            length = shrinkCase(seed, inputs, tick);
+            inputs[length] = '\0';
+            fprintf(stdout, "check: shrunk to %d inputs, reproduce with: %s -r %u %s\n", length, args[0], seed, inputs);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fprintf(stdout, "check: %d games matched the original logic\n", seeds);
+    exit(EXIT_SUCCESS);
+}
+
+#endif
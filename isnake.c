@@ -32,10 +32,21 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <ctype.h>
 #include <time.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// HEADLESS BUILDS (LIKE THE TEST HARNESS) SUPPLY THEIR OWN STAND-INS FOR SDL
+#ifndef ISNAKE_HEADLESS
 #include <SDL/SDL.h>
 #include <SDL/SDL_ttf.h>
+#endif
 
 // TITLE OF THE WINDOW
 #define GAMENAME "Intelligent Snake"
@@ -66,13 +77,55 @@
 #define MAX_SNAKELENGTH 36
 #define DEFAULT_SNAKELENGTH 4
 
+// LARGEST NUMBER OF TILES ON THE GRID
+#define MAX_TILES (MAX_TILESWIDE * MAX_TILESHIGH)
+
 // NUMBER OF NPCs (# OF BLOCKS + 1 FOR FOOD)
 #define MIN_NPCCOUNT 1
 #define MAX_NPCCOUNT 41
 #define DEFAULT_NPCCOUNT 21
 
-// AMOUNT OF FOOD EATEN BEFORE SNAKESPEED INCREASES
-#define ACCEL_FREQ 3
+// RANDOM ATTEMPTS AT FINDING A REACHABLE TILE BEFORE PICKING ONE STRAIGHT FROM THE SNAKE'S AREAS
+#define MAX_PLACEMENT_ATTEMPTS 1000
+
+// AMOUNT OF FOOD EATEN BEFORE SNAKESPEED INCREASES (0 NEVER INCREASES IT)
+#define MIN_ACCELFREQ 0
+#define MAX_ACCELFREQ 99
+#define DEFAULT_ACCELFREQ 3
+
+// AMOUNT THE SNAKE GROWS FOR EACH PIECE OF FOOD
+#define MIN_GROWTH 0
+#define MAX_GROWTH 9
+#define DEFAULT_GROWTH 1
+
+// PIECES OF FOOD ON THE GRID AT ONCE
+#define MIN_FOODCOUNT 1
+#define MAX_FOODCOUNT 9
+#define DEFAULT_FOODCOUNT 1
+
+// MILLISECONDS BETWEEN MOVES A RULES FILE CAN SET FOR EACH SPEED
+#define MIN_TICKDELAY 0
+#define MAX_TICKDELAY 10000
+
+// LONGEST LINE ALLOWED IN A RULES FILE
+#define MAX_RULESLINE 256
+
+// MOST BLOCKS A GENERATED OR PACKED LEVEL CAN HOLD
+#define MAX_LEVELBLOCKS 1200
+
+// ATTEMPTS AT GENERATING A CONNECTED LEVEL BEFORE GIVING UP
+#define MAX_LEVELATTEMPTS 100
+
+// MAZE CELL SIZE (INCLUDING ITS WALL), SMALLEST ROOM SIDE AND DOORWAY WIDTH FOR GENERATED LEVELS
+#define MAZE_CELL 6
+#define MIN_ROOMSIZE 10
+#define DOOR_WIDTH 3
+
+// LEVEL PACK FILE FORMAT: "ISLP", VERSION, WIDTH, HEIGHT, PADDING, LEVEL COUNT, THEN AN OFFSET PER LEVEL
+#define LEVELPACK_MAGIC "ISLP"
+#define LEVELPACK_VERSION 1
+#define LEVELPACK_HEADERSIZE 12
+#define MAX_LEVELPACKSIZE 1000000
 
 // WHETHER TO DISPLAY COMMANDLINE OUTPUT DURING GAMEPLAY
 #define CONSOLE_OUTPUT true
@@ -92,33 +145,122 @@ const int colourTextData[3] = { 135, 215, 255 }; // Blue
 // ENUMERATIONS FOR MORE READABLE CODE
 enum direction { Up, Down, Left, Right }; // Movement directions
 enum gameParams { QuitGame, TilesHigh, TilesWide, NPCCount, SnakeSpeed, SnakeLength, SnakeDirection, SnakeScore, RenderSizeMultiplier };
+enum collision { CollisionNone, CollisionFood, CollisionFatal }; // What the snake's head would run into
+enum blockPattern { BlocksRandom, BlocksSymmetric, BlocksMaze, BlocksRooms }; // How blocks are laid out at the start of a game
+enum layoutTile { TileFree, TileBlock, TileReserved }; // What a tile holds while a level is generated
+
+// RULES THE GAME IS PLAYED BY: LOADED ONCE AT STARTUP SO THE GAME NEVER RE-READS THEM
+struct gameRules {
+    bool wrapWalls;
+    int growthPerFood;
+    int accelFreq;
+    int foodCount;
+    enum blockPattern blockPattern;
+    int tickDelay[MAX_SNAKESPEED + 1]; // Milliseconds between moves at each speed
+};
+
+struct gameRules rules;
+
+// ROW AND COLUMN OFFSETS OF THE NEIGHBOURING TILE IN EACH DIRECTION
+static const int directionOffset[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+// BOARD ENGINES: COLLISION CHECKS SPECIALIZED FOR A GRID SIZE, WHICH ALSO HAND BACK THE (WRAPPED) TILE THE HEAD MOVES TO
+typedef enum collision (*collisionEngine)(int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int* food, int next[2]);
+
+struct boardEngine {
+    int tilesWide;
+    int tilesHigh;
+    collisionEngine engine;
+    collisionEngine wrapEngine;
+};
+
+// THE ENGINE MATCHING THE CURRENT GRID, CHOSEN ONCE AT STARTUP
+collisionEngine activeEngine = NULL;
+
+// REACHABILITY: HOW MANY SPRITES OCCUPY EACH TILE AND A UNION-FIND OF THE FREE ONES
+// Freed tiles get a fresh node so stale trees never need unlinking, and the
+// whole structure is only rebuilt when an occupied tile may have split an area
+struct reachability {
+    int tilesWide;
+    int tilesHigh;
+    int nextNode;
+    bool wrapWalls;
+    bool dirty;
+    int occupants[MAX_TILES];
+    int node[MAX_TILES];
+    int parent[2 * MAX_TILES];
+    int size[2 * MAX_TILES];
+};
+
+struct reachability reach;
+
+// A LEVEL: THE BLOCKS LAID OUT ON THE GRID FOR A GAME
+struct level {
+    int blockCount;
+    unsigned char blocks[MAX_LEVELBLOCKS][2];
+};
+
+struct level currentLevel;
+
+// A LEVEL PACK: A FILE OF PRE-GENERATED LEVELS KEPT MAPPED IN MEMORY SO ANY LEVEL LOADS INSTANTLY
+struct levelPack {
+    unsigned char* data;
+    size_t size;
+    int tilesWide;
+    int tilesHigh;
+    int levelCount;
+    int levelIndex;
+};
+
+struct levelPack pack;
 
 // GAME FUNCTIONS
 void gameLoop(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], SDL_Event* event);
-void moveSnake(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], enum direction newDirection);
+void moveSnake(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int next[2]);
 bool collisionDetect(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], enum direction newDirection);
-void collisionDetectFood(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9]);
+void collisionDetectFood(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], int food);
 bool gameEventPoll(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], SDL_Event* event);
 bool scrollSnake(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9]);
 void updateSnake(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9]);
 void loadNPCs(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9]);
-void randomLocation(int** ppSprites, int (*gameParameters)[9], int* location[2]);
+void placeSprites(int** ppSprites, int (*gameParameters)[9]);
+bool locationAcceptable(int** ppSprites, int (*gameParameters)[9], int location[2]);
+void randomLocation(int** ppSprites, int (*gameParameters)[9], int* location[2], bool mustBeReachable);
 void drawText(SDL_Surface* screen, char* string, int size, int x, int y, SDL_Colour colour);
 void updateRect(SDL_Surface* screen, SDL_Rect** ppTiles, int position[2], const int colour[3]);
 
+// ENGINE FUNCTIONS
+enum collision collisionEngineGeneric(int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int* food, int next[2]);
+enum collision collisionEngineGenericWrap(int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int* food, int next[2]);
+collisionEngine selectBoardEngine(int (*gameParameters)[9]);
+
+// REACHABILITY FUNCTIONS
+void reachReset(int** ppSprites, int (*gameParameters)[9]);
+void reachOccupy(int position[2]);
+void reachRelease(int position[2]);
+int reachAreaFromHead(int** ppSprites, int (*gameParameters)[9]);
+bool reachFromHead(int** ppSprites, int (*gameParameters)[9], int position[2]);
+bool reachSnakeTrapped(int** ppSprites, int (*gameParameters)[9]);
+bool reachRandomLocation(int** ppSprites, int (*gameParameters)[9], int location[2]);
+
+// LEVEL FUNCTIONS
+bool generateLevel(struct level* level, int tilesWide, int tilesHigh, int blockCount);
+void openLevelPack(char* filename, int index);
+void readLevel(struct level* level, int index);
+void writeLevelPack(char* filename, int levelCount, int (*gameParameters)[9]);
+
 // COMMANDLINE FUNCTIONS
 void configureGame(int argc, char** args, int (*gameParameters)[9]);
+void loadRules(char* filename);
 void printHelpMenu(char filename[]);
 void printErrorHelp(char filename[]);
 
 // MAIN LOOP
 int main(int argc, char* args[]) {
-    int x, y, gameParameters[9];
+    int x, y, gameParameters[9], startParameters[9];
     int** ppSprites = NULL;
-    int* pSprites = NULL;
     SDL_Surface* screen = NULL;
     SDL_Rect** ppTiles = NULL;
-    SDL_Rect* pTiles = NULL;
     SDL_Event event;
 
     // START RANDOM SEED TO HELP MAKE RANDOM NUMBERS MORE RANDOM
@@ -126,6 +268,10 @@ int main(int argc, char* args[]) {
 
     // CONFIGURE GAME SETTINGS USING DEFAULTS AND USER INPUT
     configureGame(argc, args, &gameParameters);
+    memcpy(startParameters, gameParameters, sizeof(gameParameters));
+
+    // PICK THE COLLISION ENGINE FOR THIS GRID SIZE AND RULE SET
+    activeEngine = selectBoardEngine(&gameParameters);
 
     // INITIALIZE SDL
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) {
@@ -160,7 +306,6 @@ int main(int argc, char* args[]) {
 
     while (gameParameters[QuitGame] == 0) {
         // INIT TILES ARRAY
-        pTiles = malloc(gameParameters[TilesWide] * sizeof(SDL_Rect));
         ppTiles = malloc(gameParameters[TilesHigh] * sizeof(SDL_Rect*));
 
         for (x = 0; x < gameParameters[TilesHigh]; x++) {
@@ -177,8 +322,17 @@ int main(int argc, char* args[]) {
             }
         }
 
+        // LAY OUT THE BLOCKS FROM THE LEVEL PACK OR GENERATE THEM FOR THIS GAME
+        if (pack.data != NULL) {
+            readLevel(&currentLevel, pack.levelIndex);
+        } else if (!generateLevel(&currentLevel, gameParameters[TilesWide], gameParameters[TilesHigh], gameParameters[NPCCount] - rules.foodCount)) {
+            fprintf(stderr, "\nUnable to generate a level where every tile can be reached\n");
+            exit(EXIT_FAILURE);
+        }
+
+        gameParameters[NPCCount] = rules.foodCount + currentLevel.blockCount;
+
         // INIT SPRITES ARRAY
-        pSprites = malloc(2 * sizeof(int));
         ppSprites = malloc((gameParameters[NPCCount] + MAX_SNAKELENGTH) * sizeof(int*)); // The array is defined by the snake's maximum size so it can grow during gameplay
 
         for (x = 0; x < gameParameters[NPCCount] + MAX_SNAKELENGTH; x++) {
@@ -187,16 +341,8 @@ int main(int argc, char* args[]) {
             ppSprites[x][1] = 0;
         }
 
-        // SET SNAKE START POSITION
-        for (x = gameParameters[NPCCount]; x < gameParameters[NPCCount] + gameParameters[SnakeLength]; x++) {
-            ppSprites[x][0] = 3;
-            ppSprites[x][1] = (3 + gameParameters[NPCCount] + gameParameters[SnakeLength] - DEFAULT_SNAKELENGTH + 2 - x);
-        }
-
-        // SET NPC LOCATIONS
-        for (x = 0; x < gameParameters[NPCCount]; x++) {
-            randomLocation(ppSprites, &gameParameters, &(ppSprites)[x]);
-        }
+        // SET THE SNAKE, BLOCKS AND FOOD IN THEIR STARTING LOCATIONS
+        placeSprites(ppSprites, &gameParameters);
 
         // GAME LOOP
         gameLoop(screen, ppTiles, ppSprites, &gameParameters, &event);
@@ -205,11 +351,10 @@ int main(int argc, char* args[]) {
         free(ppTiles);
         free(ppSprites);
         ppSprites = NULL;
-        pSprites = NULL;
 
-        // RESET GAME SETTINGS USING DEFAULTS AND USER INPUT
+        // RESET GAME SETTINGS TO THE ONES THE GAME STARTED WITH
         if (gameParameters[QuitGame] == 0) {
-            configureGame(argc, args, &gameParameters);
+            memcpy(gameParameters, startParameters, sizeof(gameParameters));
         }
     }
 
@@ -233,6 +378,7 @@ void gameLoop(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*ga
     int gameOverMsgPosition[5] = { ((TILEWIDTH * ((*gameParameters)[TilesWide] / 2)) - 147) * (*gameParameters)[RenderSizeMultiplier], ((TILEWIDTH * ((*gameParameters)[TilesWide] / 2)) - 50) * (*gameParameters)[RenderSizeMultiplier], ((TILEWIDTH * ((*gameParameters)[TilesWide] / 2)) + 61) * (*gameParameters)[RenderSizeMultiplier], ((TILEWIDTH * ((*gameParameters)[TilesWide] / 2)) + 82) * (*gameParameters)[RenderSizeMultiplier], ((TILEHEIGHT * (*gameParameters)[TilesHigh]) + 9) * (*gameParameters)[RenderSizeMultiplier] };
     char* gameOverMsg[4] = { "GAME OVER", "SPACE to RESTART", " or ", "ESC to QUIT" };
     char tempString[2][3] = { "-1", "-1" };
+    bool reportedTrapped = false;
 
     // LOAD BLOCKS AND FOOD
     loadNPCs(screen, ppTiles, ppSprites, gameParameters);
@@ -269,7 +415,7 @@ void gameLoop(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*ga
 
         updateSnake(screen, ppTiles, ppSprites, gameParameters);
         SDL_Flip(screen);
-        SDL_Delay(250 / ((*gameParameters)[SnakeSpeed] + 3));
+        SDL_Delay(rules.tickDelay[(*gameParameters)[SnakeSpeed]]);
 
         if (scrollSnake(screen, ppTiles, ppSprites, gameParameters) == false) {
             break;
@@ -277,7 +423,7 @@ void gameLoop(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*ga
 
         updateSnake(screen, ppTiles, ppSprites, gameParameters);
         SDL_Flip(screen);
-        SDL_Delay(250 / ((*gameParameters)[SnakeSpeed] + 3));
+        SDL_Delay(rules.tickDelay[(*gameParameters)[SnakeSpeed]]);
 
         if (gameEventPoll(screen, ppTiles, ppSprites, gameParameters, event) == false) {
             break;
@@ -285,6 +431,12 @@ void gameLoop(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*ga
 
         updateSnake(screen, ppTiles, ppSprites, gameParameters);
         SDL_Flip(screen);
+
+        // REPORT WHEN THE SNAKE HAS SEALED ITSELF INTO A DEAD END
+        if (CONSOLE_OUTPUT && !reportedTrapped && reachSnakeTrapped(ppSprites, gameParameters)) {
+            fprintf(stdout, "Trapped: %d reachable tiles left\n", reachAreaFromHead(ppSprites, gameParameters));
+            reportedTrapped = true;
+        }
     }
 
     // DISPLAY GAME OVER MESSAGE AND WAIT FOR INPUT
@@ -297,7 +449,7 @@ void gameLoop(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*ga
         SDL_Flip(screen);
 
         // WAIT A MOMENT TO ENSURE INPUT FROM THE GAME ISN'T CAUGHT
-        SDL_Delay(250 / ((*gameParameters)[SnakeSpeed] + 3));
+        SDL_Delay(rules.tickDelay[(*gameParameters)[SnakeSpeed]]);
 
         // CAPTURE SDL_QUIT TO EXIT, ESCAPE TO EXIT, OR SPACEBAR TO RESTART
         while (1) {
@@ -335,133 +487,826 @@ void gameLoop(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*ga
     }
 }
 
-// MOVES THE SNAKE IN THE DESIRED DIRECTION
-void moveSnake(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], enum direction newDirection) {
+// MOVES THE SNAKE IN THE DESIRED DIRECTION, ONTO THE TILE THE BOARD ENGINE WORKED OUT (ALREADY WRAPPED IF THE WALLS WRAP)
+void moveSnake(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int next[2]) {
     int x;
 
     // MOVEMENT
     for (x = (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 1; x >= (*gameParameters)[NPCCount]; x--) {
         if (x == (*gameParameters)[NPCCount]) {
-            // MOVE THE HEAD OF THE SNAKE TO THE NEW DIRECTION
-            switch (newDirection) {
-                case Up:
-                    ppSprites[x][0] = ppSprites[x][0] - 1;
-                    (*gameParameters)[SnakeDirection] = 0;
-                    break;
-
-                case Down:
-                    ppSprites[x][0] = ppSprites[x][0] + 1;
-                    (*gameParameters)[SnakeDirection] = 1;
-                    break;
-
-                case Left:
-                    ppSprites[x][1] = ppSprites[x][1] - 1;
-                    (*gameParameters)[SnakeDirection] = 2;
-                    break;
-
-                case Right:
-                    ppSprites[x][1] = ppSprites[x][1] + 1;
-                    (*gameParameters)[SnakeDirection] = 3;
-                    break;
-            }
+            // MOVE THE HEAD OF THE SNAKE ONTO ITS NEXT TILE
+            ppSprites[x][0] = next[0];
+            ppSprites[x][1] = next[1];
+            (*gameParameters)[SnakeDirection] = newDirection;
         } else {
             // MOVE THE BODY/TAIL OF THE SNAKE TO THE PIECE AHEAD OF IT
             ppSprites[x][0] = ppSprites[x - 1][0];
             ppSprites[x][1] = ppSprites[x - 1][1];
         }
     }
+
+    // THE TILE LEFT BEHIND BY THE TAIL OPENS UP BEFORE THE HEAD TAKES ITS NEW TILE
+    reachRelease(ppSprites[(*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 1]);
+    reachOccupy(ppSprites[(*gameParameters)[NPCCount]]);
 }
 
 // DETECT+HANDLE WHEN THE SNAKE COLLIDES WITH WALLS, BLOCKS, ITSELF OR FOOD
 bool collisionDetect(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], enum direction newDirection) {
+    int food, next[2];
+
+    switch (activeEngine(ppSprites, gameParameters, newDirection, &food, next)) {
+        case CollisionFatal:
+            return false;
+
+        case CollisionFood:
+            collisionDetectFood(screen, ppTiles, ppSprites, gameParameters, food);
+            break;
+
+        default:
+            break;
+    }
+
+    moveSnake(screen, ppTiles, ppSprites, gameParameters, newDirection, next);
+    return true;
+}
+
+// SHARED BODY OF EVERY BOARD ENGINE: ALWAYS INLINED (EVEN WITHOUT OPTIMIZATION) WITH CONSTANT GRID SIZES AND WALL RULES SO THE BOUNDS CHECK FOLDS AWAY
+static inline __attribute__((always_inline)) enum collision collisionScan(int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int* food, int next[2], const int tilesWide, const int tilesHigh, const bool wrapWalls) {
     int x;
+    int* tail = ppSprites[(*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2];
+    int nextRow = ppSprites[(*gameParameters)[NPCCount]][0] + directionOffset[newDirection][0];
+    int nextColumn = ppSprites[(*gameParameters)[NPCCount]][1] + directionOffset[newDirection][1];
+
+    if (wrapWalls) {
+        // WALLS LEAD AROUND TO THE OTHER SIDE
+        nextRow = (nextRow + tilesHigh) % tilesHigh;
+        nextColumn = (nextColumn + tilesWide) % tilesWide;
+    } else if (((unsigned int)nextRow >= (unsigned int)tilesHigh) || ((unsigned int)nextColumn >= (unsigned int)tilesWide)) {
+        // WALLS (THE UNSIGNED COMPARISON CATCHES BOTH SIDES OF THE GRID AT ONCE)
+        return CollisionFatal;
+    }
 
-    switch (newDirection) {
-        case Up:
-            for (x = 0; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2; ++x) {
-                if (((ppSprites[(*gameParameters)[NPCCount]][0] - 1) == ppSprites[x][0]) && (ppSprites[(*gameParameters)[NPCCount]][1] == ppSprites[x][1])) {
-                    if (x == 0) {
-                        collisionDetectFood(screen, ppTiles, ppSprites, gameParameters);
-                    } else {
-                        return false;
-                    }
+    next[0] = nextRow;
+    next[1] = nextColumn;
+
+    // FOOD
+    for (x = 0; x < rules.foodCount; ++x) {
+        if ((ppSprites[x][0] == nextRow) && (ppSprites[x][1] == nextColumn)) {
+            *food = x;
+            return CollisionFood;
+        }
+    }
+
+    // BLOCKS AND THE SNAKE ITSELF, LOOKED UP IN THE OCCUPANCY GRID (THE TAIL WILL HAVE MOVED ON)
+    if (reach.occupants[(nextRow * tilesWide) + nextColumn] > (((tail[0] == nextRow) && (tail[1] == nextColumn)) ? 1 : 0)) {
+        return CollisionFatal;
+    }
+
+    return CollisionNone;
+}
+
+// GENERATES THE BOARD ENGINES (SOLID AND WRAPPING WALLS) FOR A FIXED GRID SIZE
+#define BOARD_ENGINE(WIDE, HIGH) \
+    static enum collision collisionEngine##WIDE##x##HIGH(int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int* food, int next[2]) { \
+        return collisionScan(ppSprites, gameParameters, newDirection, food, next, WIDE, HIGH, false); \
+    } \
+    static enum collision collisionEngine##WIDE##x##HIGH##Wrap(int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int* food, int next[2]) { \
+        return collisionScan(ppSprites, gameParameters, newDirection, food, next, WIDE, HIGH, true); \
+    }
+
+BOARD_ENGINE(50, 30) // DEFAULT_TILESWIDE x DEFAULT_TILESHIGH
+BOARD_ENGINE(80, 50) // MAX_TILESWIDE x MAX_TILESHIGH
+BOARD_ENGINE(32, 32)
+BOARD_ENGINE(64, 32)
+
+// FALLBACK BOARD ENGINES FOR ANY OTHER GRID SIZE
+enum collision collisionEngineGeneric(int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int* food, int next[2]) {
+    return collisionScan(ppSprites, gameParameters, newDirection, food, next, (*gameParameters)[TilesWide], (*gameParameters)[TilesHigh], false);
+}
+
+enum collision collisionEngineGenericWrap(int** ppSprites, int (*gameParameters)[9], enum direction newDirection, int* food, int next[2]) {
+    return collisionScan(ppSprites, gameParameters, newDirection, food, next, (*gameParameters)[TilesWide], (*gameParameters)[TilesHigh], true);
+}
+
+// RETURNS THE SPECIALIZED BOARD ENGINE FOR THE GRID SIZE AND WALLS, OR THE GENERIC ONE IF THERE ISN'T ONE
+collisionEngine selectBoardEngine(int (*gameParameters)[9]) {
+    static const struct boardEngine boardEngines[] = {
+        { 50, 30, collisionEngine50x30, collisionEngine50x30Wrap },
+        { 80, 50, collisionEngine80x50, collisionEngine80x50Wrap },
+        { 32, 32, collisionEngine32x32, collisionEngine32x32Wrap },
+        { 64, 32, collisionEngine64x32, collisionEngine64x32Wrap }
+    };
+    int x;
+
+    for (x = 0; x < (int)(sizeof(boardEngines) / sizeof(boardEngines[0])); x++) {
+        if ((boardEngines[x].tilesWide == (*gameParameters)[TilesWide]) && (boardEngines[x].tilesHigh == (*gameParameters)[TilesHigh])) {
+            return (rules.wrapWalls ? boardEngines[x].wrapEngine : boardEngines[x].engine);
+        }
+    }
+
+    return (rules.wrapWalls ? collisionEngineGenericWrap : collisionEngineGeneric);
+}
+
+// RETURNS THE TILE INDEX AT A ROW AND COLUMN, OR -1 IF IT'S OFF THE GRID
+static int reachTile(int row, int column) {
+    if (reach.wrapWalls) {
+        return ((((row + reach.tilesHigh) % reach.tilesHigh) * reach.tilesWide) + ((column + reach.tilesWide) % reach.tilesWide));
+    }
+
+    if ((row < 0) || (row >= reach.tilesHigh) || (column < 0) || (column >= reach.tilesWide)) {
+        return -1;
+    }
+
+    return (row * reach.tilesWide) + column;
+}
+
+// FINDS THE ROOT NODE OF AN AREA, HALVING THE PATH ON THE WAY UP
+static int reachFind(int node) {
+    while (reach.parent[node] != node) {
+        reach.parent[node] = reach.parent[reach.parent[node]];
+        node = reach.parent[node];
+    }
+
+    return node;
+}
+
+// MERGES THE AREAS OF TWO NODES, HANGING THE SMALLER UNDER THE LARGER
+static void reachJoin(int first, int second) {
+    first = reachFind(first);
+    second = reachFind(second);
+
+    if (first == second) {
+        return;
+    }
+
+    if (reach.size[first] < reach.size[second]) {
+        reach.parent[first] = second;
+        reach.size[second] += reach.size[first];
+    } else {
+        reach.parent[second] = first;
+        reach.size[first] += reach.size[second];
+    }
+}
+
+// GIVES A FREE TILE A FRESH NODE AND JOINS IT TO ITS FREE NEIGHBOURS
+static void reachAddTile(int row, int column) {
+    int x, tile = reachTile(row, column), neighbour;
+
+    reach.node[tile] = reach.nextNode;
+    reach.parent[reach.nextNode] = reach.nextNode;
+    reach.size[reach.nextNode] = 1;
+    reach.nextNode++;
+
+    for (x = Up; x <= Right; x++) {
+        neighbour = reachTile(row + directionOffset[x][0], column + directionOffset[x][1]);
+
+        if ((neighbour != -1) && (reach.occupants[neighbour] == 0) && (reach.node[neighbour] != -1)) {
+            reachJoin(reach.node[tile], reach.node[neighbour]);
+        }
+    }
+}
+
+// REBUILDS EVERY AREA FROM THE OCCUPIED TILES
+static void reachRebuild(void) {
+    int row, column;
+
+    reach.nextNode = 0;
+
+    for (row = 0; row < MAX_TILES; row++) {
+        reach.node[row] = -1;
+    }
+
+    for (row = 0; row < reach.tilesHigh; row++) {
+        for (column = 0; column < reach.tilesWide; column++) {
+            if (reach.occupants[reachTile(row, column)] == 0) {
+                reachAddTile(row, column);
+            }
+        }
+    }
+
+    reach.dirty = false;
+}
+
+// WHETHER OCCUPYING A TILE COULD CUT ITS FREE NEIGHBOURS OFF FROM EACH OTHER
+// They stay connected if they all sit on one unbroken run of free tiles around it
+static bool reachMaySplit(int row, int column) {
+    static const int ring[8][2] = { { -1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 }, { 1, 0 }, { 1, -1 }, { 0, -1 }, { -1, -1 } };
+    bool ringFree[8], touchesNeighbour;
+    int x, y, tile, runs = 0;
+
+    for (x = 0; x < 8; x++) {
+        tile = reachTile(row + ring[x][0], column + ring[x][1]);
+        ringFree[x] = ((tile != -1) && (reach.occupants[tile] == 0));
+    }
+
+    for (x = 0; x < 8; x++) {
+        if (ringFree[x] && !ringFree[(x + 7) % 8]) {
+            touchesNeighbour = false;
+
+            for (y = x; ringFree[y % 8] && (y < x + 8); y++) {
+                if ((y % 2) == 0) {
+                    touchesNeighbour = true;
                 }
             }
 
-            if ((ppSprites[(*gameParameters)[NPCCount]][0] - 1) < 0) {
-                return false;
+            if (touchesNeighbour) {
+                runs++;
             }
+        }
+    }
 
-            moveSnake(screen, ppTiles, ppSprites, gameParameters, Up);
-            break;
+    return (runs > 1);
+}
 
-        case Down:
-            for (x = 0; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2; ++x) {
-                if (((ppSprites[(*gameParameters)[NPCCount]][0] + 1) == ppSprites[x][0]) && (ppSprites[(*gameParameters)[NPCCount]][1] == ppSprites[x][1])) {
-                    if (x == 0) {
-                        collisionDetectFood(screen, ppTiles, ppSprites, gameParameters);
-                    } else {
-                        return false;
-                    }
-                }
+// MARKS THE BLOCKS AND SNAKE AS OCCUPIED AND BUILDS THE AREAS FROM SCRATCH
+void reachReset(int** ppSprites, int (*gameParameters)[9]) {
+    int x;
+
+    reach.tilesWide = (*gameParameters)[TilesWide];
+    reach.tilesHigh = (*gameParameters)[TilesHigh];
+    reach.wrapWalls = rules.wrapWalls;
+
+    for (x = 0; x < reach.tilesWide * reach.tilesHigh; x++) {
+        reach.occupants[x] = 0;
+    }
+
+    // FOOD AND THE TILE BEHIND THE TAIL ARE FREE TO MOVE INTO
+    for (x = rules.foodCount; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 1; x++) {
+        reach.occupants[reachTile(ppSprites[x][0], ppSprites[x][1])]++;
+    }
+
+    reachRebuild();
+}
+
+// ADDS AN OCCUPANT TO A TILE, FLAGGING A REBUILD ONLY IF AN AREA MIGHT HAVE SPLIT
+void reachOccupy(int position[2]) {
+    int tile = reachTile(position[0], position[1]);
+
+    if (reach.occupants[tile]++ > 0) {
+        return;
+    }
+
+    if (!reach.dirty) {
+        reach.size[reachFind(reach.node[tile])]--;
+        reach.dirty = reachMaySplit(position[0], position[1]);
+    }
+}
+
+// REMOVES AN OCCUPANT FROM A TILE, JOINING IT TO THE AREAS AROUND IT ONCE IT'S FREE
+void reachRelease(int position[2]) {
+    int tile = reachTile(position[0], position[1]);
+
+    if ((reach.occupants[tile] == 0) || (--reach.occupants[tile] > 0)) {
+        return;
+    }
+
+    if (!reach.dirty) {
+        if (reach.nextNode < 2 * MAX_TILES) {
+            reachAddTile(position[0], position[1]);
+        } else {
+            reach.dirty = true;
+        }
+    }
+}
+
+// COLLECTS THE DISTINCT AREAS TOUCHING THE SNAKE'S HEAD AND RETURNS HOW MANY THERE ARE
+static int reachHeadAreas(int** ppSprites, int (*gameParameters)[9], int roots[4]) {
+    int x, y, tile, root, count = 0;
+    int* head = ppSprites[(*gameParameters)[NPCCount]];
+
+    if (reach.dirty) {
+        reachRebuild();
+    }
+
+    for (x = Up; x <= Right; x++) {
+        tile = reachTile(head[0] + directionOffset[x][0], head[1] + directionOffset[x][1]);
+
+        if ((tile != -1) && (reach.occupants[tile] == 0)) {
+            root = reachFind(reach.node[tile]);
+
+            for (y = 0; (y < count) && (roots[y] != root); y++);
+
+            if (y == count) {
+                roots[count++] = root;
             }
+        }
+    }
+
+    return count;
+}
+
+// NUMBER OF FREE TILES THE SNAKE'S HEAD CAN STILL GET TO
+int reachAreaFromHead(int** ppSprites, int (*gameParameters)[9]) {
+    int x, roots[4], area = 0, count = reachHeadAreas(ppSprites, gameParameters, roots);
+
+    for (x = 0; x < count; x++) {
+        area += reach.size[roots[x]];
+    }
+
+    return area;
+}
+
+// WHETHER THE SNAKE'S HEAD CAN GET TO A TILE (OR, IF IT'S OCCUPIED, RIGHT NEXT TO IT)
+bool reachFromHead(int** ppSprites, int (*gameParameters)[9], int position[2]) {
+    int x, y, tile = reachTile(position[0], position[1]), roots[4], count = reachHeadAreas(ppSprites, gameParameters, roots);
+    int* head = ppSprites[(*gameParameters)[NPCCount]];
 
-            if ((ppSprites[(*gameParameters)[NPCCount]][0] + 1) >= (*gameParameters)[TilesHigh]) {
-                return false;
+    for (x = Up; x <= Right; x++) {
+        if (reachTile(head[0] + directionOffset[x][0], head[1] + directionOffset[x][1]) == tile) {
+            return true;
+        }
+    }
+
+    if (reach.occupants[tile] == 0) {
+        for (y = 0; y < count; y++) {
+            if (roots[y] == reachFind(reach.node[tile])) {
+                return true;
             }
+        }
 
-            moveSnake(screen, ppTiles, ppSprites, gameParameters, Down);
-            break;
+        return false;
+    }
 
-        case Left:
-            for (x = 0; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2; ++x) {
-                if (((ppSprites[(*gameParameters)[NPCCount]][1] - 1) == ppSprites[x][1]) && (ppSprites[(*gameParameters)[NPCCount]][0] == ppSprites[x][0])) {
-                    if (x == 0) {
-                        collisionDetectFood(screen, ppTiles, ppSprites, gameParameters);
-                    } else {
-                        return false;
-                    }
+    for (x = Up; x <= Right; x++) {
+        tile = reachTile(position[0] + directionOffset[x][0], position[1] + directionOffset[x][1]);
+
+        if ((tile != -1) && (reach.occupants[tile] == 0)) {
+            for (y = 0; y < count; y++) {
+                if (roots[y] == reachFind(reach.node[tile])) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+// A DEAD END: NOT ENOUGH ROOM LEFT TO FIT THE SNAKE AND NO WAY BACK TO ITS TAIL
+bool reachSnakeTrapped(int** ppSprites, int (*gameParameters)[9]) {
+    return ((reachAreaFromHead(ppSprites, gameParameters) < (*gameParameters)[SnakeLength] - 1) && !reachFromHead(ppSprites, gameParameters, ppSprites[(*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2]));
+}
+
+// PICKS A RANDOM ACCEPTABLE TILE FROM THE AREAS TOUCHING THE SNAKE'S HEAD, OR RETURNS FALSE IF THEY HAVE NONE
+// Like randomLocation's random tries, it leaves out the outermost rows and columns
+bool reachRandomLocation(int** ppSprites, int (*gameParameters)[9], int location[2]) {
+    int x, y, tile, pick = 0, candidates = 0, roots[4], count = reachHeadAreas(ppSprites, gameParameters, roots);
+
+    // COUNT THE CANDIDATES ON THE FIRST PASS, THEN STOP ON THE RANDOMLY PICKED ONE ON THE SECOND
+    for (x = 0; x < 2; x++) {
+        for (location[0] = 1; location[0] < reach.tilesHigh - 1; location[0]++) {
+            for (location[1] = 1; location[1] < reach.tilesWide - 1; location[1]++) {
+                tile = reachTile(location[0], location[1]);
+
+                if ((reach.occupants[tile] != 0) || !locationAcceptable(ppSprites, gameParameters, location)) {
+                    continue;
                 }
+
+                for (y = 0; (y < count) && (roots[y] != reachFind(reach.node[tile])); y++);
+
+                if (y == count) {
+                    continue;
+                }
+
+                if (x == 0) {
+                    candidates++;
+                } else if (pick-- == 0) {
+                    return true;
+                }
+            }
+        }
+
+        if (candidates == 0) {
+            return false;
+        }
+
+        pick = rand() % candidates;
+    }
+
+    return false;
+}
+
+// BLOCKS A LAYOUT TILE UNLESS IT'S RESERVED FOR THE SNAKE
+static void layoutBlock(unsigned char* grid, int tilesWide, int row, int column) {
+    if (grid[(row * tilesWide) + column] == TileFree) {
+        grid[(row * tilesWide) + column] = TileBlock;
+    }
+}
+
+// OPENS A DOORWAY CENTRED ON A TILE, RUNNING ALONG A HORIZONTAL OR VERTICAL WALL
+static void layoutDoor(unsigned char* grid, int tilesWide, int tilesHigh, int row, int column, bool horizontalWall) {
+    int x, tile;
+
+    for (x = -(DOOR_WIDTH / 2); x <= DOOR_WIDTH / 2; x++) {
+        if (horizontalWall && (column + x >= 0) && (column + x < tilesWide)) {
+            tile = (row * tilesWide) + column + x;
+        } else if (!horizontalWall && (row + x >= 0) && (row + x < tilesHigh)) {
+            tile = ((row + x) * tilesWide) + column;
+        } else {
+            continue;
+        }
+
+        if (grid[tile] == TileBlock) {
+            grid[tile] = TileFree;
+        }
+    }
+}
+
+// SCATTERS BLOCKS AWAY FROM THE EDGES, MIRRORING EACH ONE THROUGH THE CENTRE WHEN SYMMETRIC
+static void layoutScatter(unsigned char* grid, int tilesWide, int tilesHigh, int blockCount, bool symmetric) {
+    int placed = 0, attempts = 0, tile, mirror;
+
+    while ((placed < blockCount) && (attempts++ < MAX_TILES * 4)) {
+        tile = ((((rand() % (tilesHigh - 2)) + 1) * tilesWide) + (rand() % (tilesWide - 2)) + 1);
+        mirror = (tilesWide * tilesHigh) - 1 - tile;
+
+        if (grid[tile] != TileFree) {
+            continue;
+        }
+
+        if (symmetric && (placed + 1 < blockCount)) {
+            if ((mirror == tile) || (grid[mirror] != TileFree)) {
+                continue;
             }
 
-            if ((ppSprites[(*gameParameters)[NPCCount]][1] - 1) < 0) {
-                return false;
+            grid[mirror] = TileBlock;
+            placed++;
+        }
+
+        grid[tile] = TileBlock;
+        placed++;
+    }
+}
+
+// FIRST ROW OR COLUMN OF A MAZE CELL, AND THE LAST ONE BEFORE THE NEXT WALL
+static int layoutCellStart(int cell) {
+    return ((cell * MAZE_CELL) + ((cell > 0) ? 1 : 0));
+}
+
+static int layoutCellEnd(int cell, int cells, int tiles) {
+    return ((cell + 1 < cells) ? ((cell + 1) * MAZE_CELL) - 1 : tiles - 1);
+}
+
+// DRAWS A LATTICE OF WALLS, CARVES A RANDOM SPANNING TREE OF DOORWAYS THROUGH IT, THEN OPENS SOME LOOPS
+static void layoutMaze(unsigned char* grid, int tilesWide, int tilesHigh) {
+    int cellsHigh = (tilesHigh - 3) / MAZE_CELL + 1, cellsWide = (tilesWide - 3) / MAZE_CELL + 1;
+    int row, column, cell, next, direction, count, options[4], stack[MAX_TILES];
+    bool visited[MAX_TILES], opened[MAX_TILES][2];
+    int depth = 0;
+
+    // WALLS ALONG EVERY CELL BOUNDARY
+    for (row = 0; row < tilesHigh; row++) {
+        for (column = 0; column < tilesWide; column++) {
+            if (((row > 0) && (row % MAZE_CELL == 0) && (row / MAZE_CELL < cellsHigh)) || ((column > 0) && (column % MAZE_CELL == 0) && (column / MAZE_CELL < cellsWide))) {
+                layoutBlock(grid, tilesWide, row, column);
             }
+        }
+    }
 
-            moveSnake(screen, ppTiles, ppSprites, gameParameters, Left);
-            break;
+    for (cell = 0; cell < cellsHigh * cellsWide; cell++) {
+        visited[cell] = false;
+        opened[cell][0] = false; // Wall below the cell
+        opened[cell][1] = false; // Wall right of the cell
+    }
 
-        case Right:
-            for (x = 0; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2; ++x) {
-                if (((ppSprites[(*gameParameters)[NPCCount]][1] + 1) == ppSprites[x][1]) && (ppSprites[(*gameParameters)[NPCCount]][0] == ppSprites[x][0])) {
-                    if (x == 0) {
-                        collisionDetectFood(screen, ppTiles, ppSprites, gameParameters);
-                    } else {
-                        return false;
+    // DEPTH-FIRST WALK OVER THE CELLS, OPENING A DOORWAY INTO EACH NEW ONE
+    stack[depth++] = 0;
+    visited[0] = true;
+
+    while (depth > 0) {
+        cell = stack[depth - 1];
+        row = cell / cellsWide;
+        column = cell % cellsWide;
+        count = 0;
+
+        for (direction = Up; direction <= Right; direction++) {
+            if ((row + directionOffset[direction][0] >= 0) && (row + directionOffset[direction][0] < cellsHigh) && (column + directionOffset[direction][1] >= 0) && (column + directionOffset[direction][1] < cellsWide) && !visited[cell + (directionOffset[direction][0] * cellsWide) + directionOffset[direction][1]]) {
+                options[count++] = direction;
+            }
+        }
+
+        if (count == 0) {
+            depth--;
+            continue;
+        }
+
+        direction = options[rand() % count];
+        next = cell + (directionOffset[direction][0] * cellsWide) + directionOffset[direction][1];
+
+        if ((direction == Up) || (direction == Left)) {
+            opened[next][(direction == Up) ? 0 : 1] = true;
+        } else {
+            opened[cell][(direction == Down) ? 0 : 1] = true;
+        }
+
+        visited[next] = true;
+        stack[depth++] = next;
+    }
+
+    // OPEN THE DOORWAYS, PLUS A THIRD OF THE REMAINING WALLS SO THE MAZE HAS LOOPS
+    for (cell = 0; cell < cellsHigh * cellsWide; cell++) {
+        row = cell / cellsWide;
+        column = cell % cellsWide;
+
+        if ((row + 1 < cellsHigh) && (opened[cell][0] || (rand() % 3 == 0))) {
+            layoutDoor(grid, tilesWide, tilesHigh, (row + 1) * MAZE_CELL, (layoutCellStart(column) + layoutCellEnd(column, cellsWide, tilesWide)) / 2, true);
+        }
+
+        if ((column + 1 < cellsWide) && (opened[cell][1] || (rand() % 3 == 0))) {
+            layoutDoor(grid, tilesWide, tilesHigh, (layoutCellStart(row) + layoutCellEnd(row, cellsHigh, tilesHigh)) / 2, (column + 1) * MAZE_CELL, false);
+        }
+    }
+}
+
+// SPLITS AN AREA INTO ROOMS WITH A WALL AND A DOORWAY, THEN SPLITS EACH SIDE THE SAME WAY
+static void layoutRooms(unsigned char* grid, int tilesWide, int tilesHigh, int top, int left, int bottom, int right) {
+    int x, wall, areaHigh = bottom - top + 1, areaWide = right - left + 1;
+    bool splitColumns;
+
+    if ((areaWide < (2 * MIN_ROOMSIZE) + 1) && (areaHigh < (2 * MIN_ROOMSIZE) + 1)) {
+        return;
+    }
+
+    splitColumns = ((areaWide >= (2 * MIN_ROOMSIZE) + 1) && ((areaWide >= areaHigh) || (areaHigh < (2 * MIN_ROOMSIZE) + 1)));
+
+    if (splitColumns) {
+        wall = left + MIN_ROOMSIZE + (rand() % (areaWide - (2 * MIN_ROOMSIZE)));
+
+        for (x = top; x <= bottom; x++) {
+            layoutBlock(grid, tilesWide, x, wall);
+        }
+
+        layoutDoor(grid, tilesWide, tilesHigh, top + (DOOR_WIDTH / 2) + (rand() % (areaHigh - DOOR_WIDTH + 1)), wall, false);
+        layoutRooms(grid, tilesWide, tilesHigh, top, left, bottom, wall - 1);
+        layoutRooms(grid, tilesWide, tilesHigh, top, wall + 1, bottom, right);
+    } else {
+        wall = top + MIN_ROOMSIZE + (rand() % (areaHigh - (2 * MIN_ROOMSIZE)));
+
+        for (x = left; x <= right; x++) {
+            layoutBlock(grid, tilesWide, wall, x);
+        }
+
+        layoutDoor(grid, tilesWide, tilesHigh, wall, left + (DOOR_WIDTH / 2) + (rand() % (areaWide - DOOR_WIDTH + 1)), true);
+        layoutRooms(grid, tilesWide, tilesHigh, top, left, wall - 1, right);
+        layoutRooms(grid, tilesWide, tilesHigh, wall + 1, left, bottom, right);
+    }
+}
+
+// WHETHER EVERY FREE TILE CAN BE REACHED FROM EVERY OTHER ONE WITHOUT WRAPPING AROUND THE WALLS
+static bool layoutConnected(unsigned char* grid, int tilesWide, int tilesHigh) {
+    int x, tile, row, column, head = 0, tail = 0, freeTiles = 0, queue[MAX_TILES];
+    bool seen[MAX_TILES];
+
+    for (tile = 0; tile < tilesWide * tilesHigh; tile++) {
+        seen[tile] = false;
+
+        if (grid[tile] != TileBlock) {
+            freeTiles++;
+
+            if (tail == 0) {
+                queue[tail++] = tile;
+                seen[tile] = true;
+            }
+        }
+    }
+
+    while (head < tail) {
+        tile = queue[head++];
+
+        for (x = Up; x <= Right; x++) {
+            row = (tile / tilesWide) + directionOffset[x][0];
+            column = (tile % tilesWide) + directionOffset[x][1];
+
+            if ((row >= 0) && (row < tilesHigh) && (column >= 0) && (column < tilesWide) && (grid[(row * tilesWide) + column] != TileBlock) && !seen[(row * tilesWide) + column]) {
+                seen[(row * tilesWide) + column] = true;
+                queue[tail++] = (row * tilesWide) + column;
+            }
+        }
+    }
+
+    return (tail == freeTiles);
+}
+
+// GENERATES A LEVEL USING THE RULE SET'S PATTERN, RETRYING UNTIL EVERY FREE TILE IS CONNECTED
+bool generateLevel(struct level* level, int tilesWide, int tilesHigh, int blockCount) {
+    unsigned char grid[MAX_TILES];
+    int attempt, row, column;
+
+    for (attempt = 0; attempt < MAX_LEVELATTEMPTS; attempt++) {
+        // KEEP THE SNAKE'S STARTING ROW AND THE ROWS ON EITHER SIDE OF IT CLEAR
+        for (row = 0; row < tilesHigh; row++) {
+            for (column = 0; column < tilesWide; column++) {
+                grid[(row * tilesWide) + column] = (((row >= 2) && (row <= 4) && (column >= 1) && (column <= MAX_SNAKELENGTH + 2)) ? TileReserved : TileFree);
+            }
+        }
+
+        switch (rules.blockPattern) {
+            case BlocksMaze:
+                layoutMaze(grid, tilesWide, tilesHigh);
+                break;
+
+            case BlocksRooms:
+                layoutRooms(grid, tilesWide, tilesHigh, 0, 0, tilesHigh - 1, tilesWide - 1);
+                break;
+
+            default:
+                layoutScatter(grid, tilesWide, tilesHigh, blockCount, (rules.blockPattern == BlocksSymmetric));
+                break;
+        }
+
+        if (!layoutConnected(grid, tilesWide, tilesHigh)) {
+            continue;
+        }
+
+        level->blockCount = 0;
+
+        for (row = 0; (row < tilesHigh) && (level->blockCount <= MAX_LEVELBLOCKS); row++) {
+            for (column = 0; column < tilesWide; column++) {
+                if (grid[(row * tilesWide) + column] == TileBlock) {
+                    if (level->blockCount < MAX_LEVELBLOCKS) {
+                        level->blocks[level->blockCount][0] = row;
+                        level->blocks[level->blockCount][1] = column;
                     }
+
+                    level->blockCount++;
                 }
             }
+        }
 
-            if ((ppSprites[(*gameParameters)[NPCCount]][1] + 1) >= (*gameParameters)[TilesWide]) {
-                return false;
-            }
+        if (level->blockCount <= MAX_LEVELBLOCKS) {
+            return true;
+        }
+    }
 
-            moveSnake(screen, ppTiles, ppSprites, gameParameters, Right);
-            break;
+    return false;
+}
+
+// HELPERS FOR THE LITTLE-ENDIAN NUMBERS IN LEVEL PACKS
+static unsigned int readPackNumber(unsigned char* data, int bytes) {
+    unsigned int number = 0;
+    int x;
+
+    for (x = bytes - 1; x >= 0; x--) {
+        number = (number << 8) | data[x];
     }
 
-    return true;
+    return number;
+}
+
+static void writePackNumber(FILE* file, unsigned int number, int bytes) {
+    int x;
+
+    for (x = 0; x < bytes; x++) {
+        fputc((number >> (8 * x)) & 0xFF, file);
+    }
+}
+
+// MAPS A LEVEL PACK INTO MEMORY AND CHECKS ITS HEADER
+void openLevelPack(char* filename, int index) {
+#ifndef _WIN32
+    struct stat fileInfo;
+    int descriptor;
+
+    if (((descriptor = open(filename, O_RDONLY)) == -1) || (fstat(descriptor, &fileInfo) == -1) || (fileInfo.st_size < LEVELPACK_HEADERSIZE)) {
+        fprintf(stderr, "  Error: unable to open level pack %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    pack.size = fileInfo.st_size;
+    pack.data = mmap(NULL, pack.size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+
+    if (pack.data == MAP_FAILED) {
+        fprintf(stderr, "  Error: unable to map level pack %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+#else
+    FILE* file;
+    long size;
+
+    // NO MMAP ON WINDOWS: READ THE WHOLE PACK IN ONCE INSTEAD
+    if (((file = fopen(filename, "rb")) == NULL) || (fseek(file, 0, SEEK_END) != 0) || ((size = ftell(file)) < LEVELPACK_HEADERSIZE)) {
+        fprintf(stderr, "  Error: unable to open level pack %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    pack.size = size;
+    pack.data = malloc(pack.size);
+    rewind(file);
+
+    if (fread(pack.data, 1, pack.size, file) != pack.size) {
+        fprintf(stderr, "  Error: unable to read level pack %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    fclose(file);
+#endif
+
+    pack.tilesWide = pack.data[5];
+    pack.tilesHigh = pack.data[6];
+    pack.levelCount = readPackNumber(pack.data + 8, 4);
+    pack.levelIndex = index;
+
+    if ((memcmp(pack.data, LEVELPACK_MAGIC, 4) != 0) || (pack.data[4] != LEVELPACK_VERSION) || (pack.tilesWide < MIN_TILESWIDE) || (pack.tilesWide > MAX_TILESWIDE) || (pack.tilesHigh < MIN_TILESHIGH) || (pack.tilesHigh > MAX_TILESHIGH) || (pack.levelCount < 0) || (pack.levelCount > MAX_LEVELPACKSIZE) || (LEVELPACK_HEADERSIZE + (4 * (size_t)pack.levelCount) > pack.size)) {
+        fprintf(stderr, "  Error: %s is not a valid level pack\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    if ((index < 0) || (index >= pack.levelCount)) {
+        fprintf(stderr, "  Error: level %d is not in %s, which has %d levels\n", index, filename, pack.levelCount);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// COPIES A LEVEL OUT OF THE MAPPED LEVEL PACK
+void readLevel(struct level* level, int index) {
+    size_t offset = readPackNumber(pack.data + LEVELPACK_HEADERSIZE + (4 * index), 4);
+    int x;
+
+    if ((offset + 2 > pack.size) || ((level->blockCount = readPackNumber(pack.data + offset, 2)) > MAX_LEVELBLOCKS) || (offset + 2 + (2 * (size_t)level->blockCount) > pack.size)) {
+        fprintf(stderr, "  Error: level %d of the level pack is damaged\n", index);
+        exit(EXIT_FAILURE);
+    }
+
+    for (x = 0; x < level->blockCount; x++) {
+        level->blocks[x][0] = pack.data[offset + 2 + (2 * x)];
+        level->blocks[x][1] = pack.data[offset + 3 + (2 * x)];
+
+        if ((level->blocks[x][0] >= pack.tilesHigh) || (level->blocks[x][1] >= pack.tilesWide)) {
+            fprintf(stderr, "  Error: level %d of the level pack is damaged\n", index);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// GENERATES LEVELS FOR THE CURRENT GRID AND RULE SET AND WRITES THEM TO A LEVEL PACK
+void writeLevelPack(char* filename, int levelCount, int (*gameParameters)[9]) {
+    FILE* file;
+    struct level level;
+    unsigned int offset = LEVELPACK_HEADERSIZE + (4 * levelCount);
+    int x, y;
+
+    if ((file = fopen(filename, "wb")) == NULL) {
+        fprintf(stderr, "  Error: unable to write level pack %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    fwrite(LEVELPACK_MAGIC, 1, 4, file);
+    fputc(LEVELPACK_VERSION, file);
+    fputc((*gameParameters)[TilesWide], file);
+    fputc((*gameParameters)[TilesHigh], file);
+    fputc(0, file);
+    writePackNumber(file, levelCount, 4);
+
+    // LEAVE ROOM FOR THE OFFSETS, WHICH ARE ONLY KNOWN ONCE EACH LEVEL IS WRITTEN
+    fseek(file, offset, SEEK_SET);
+
+    for (x = 0; x < levelCount; x++) {
+        if (!generateLevel(&level, (*gameParameters)[TilesWide], (*gameParameters)[TilesHigh], (*gameParameters)[NPCCount] - rules.foodCount)) {
+            fprintf(stderr, "  Error: unable to generate a level where every tile can be reached\n");
+            exit(EXIT_FAILURE);
+        }
+
+        writePackNumber(file, level.blockCount, 2);
+
+        for (y = 0; y < level.blockCount; y++) {
+            fputc(level.blocks[y][0], file);
+            fputc(level.blocks[y][1], file);
+        }
+
+        fseek(file, LEVELPACK_HEADERSIZE + (4 * x), SEEK_SET);
+        writePackNumber(file, offset, 4);
+        offset += 2 + (2 * level.blockCount);
+        fseek(file, offset, SEEK_SET);
+    }
+
+    if (fclose(file) != 0) {
+        fprintf(stderr, "  Error: unable to write level pack %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
 }
 
 // HANDLES COLLISION WITH FOOD
-void collisionDetectFood(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9]) {
-    // INCREASE THE SNAKE'S SIZE IF IT'S NOT ALREADY THE MAXIMUM
-    if ((*gameParameters)[SnakeLength] < MAX_SNAKELENGTH) {
+void collisionDetectFood(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9], int food) {
+    int x, tail;
+
+    // INCREASE THE SNAKE'S SIZE UNTIL IT'S GROWN ENOUGH OR REACHES THE MAXIMUM
+    for (x = 0; (x < rules.growthPerFood) && ((*gameParameters)[SnakeLength] < MAX_SNAKELENGTH); x++) {
         (*gameParameters)[SnakeLength]++;
+        tail = (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2;
+
+        // EXTRA PIECES STACK ON THE TILE BEHIND THE OLD TAIL AND UNFOLD AS THE SNAKE MOVES
+        if (x > 0) {
+            ppSprites[tail][0] = ppSprites[tail - 1][0];
+            ppSprites[tail][1] = ppSprites[tail - 1][1];
+        }
+
+        // THE TILE BEHIND THE OLD TAIL BECOMES PART OF THE SNAKE
+        reachOccupy(ppSprites[tail]);
     }
 
-    // INCREASE THE SNAKE'S SPEED WHEN THE SCORE IS DIVISIBLE BY ACCEL_FREQ
-    if ((((*gameParameters)[SnakeScore] % ACCEL_FREQ) == 0) && ((*gameParameters)[SnakeScore] != 0) && ((*gameParameters)[SnakeSpeed] < MAX_SNAKESPEED)) {
+    // INCREASE THE SNAKE'S SPEED WHEN THE SCORE IS DIVISIBLE BY THE ACCELERATION FREQUENCY
+    if ((rules.accelFreq != 0) && (((*gameParameters)[SnakeScore] % rules.accelFreq) == 0) && ((*gameParameters)[SnakeScore] != 0) && ((*gameParameters)[SnakeSpeed] < MAX_SNAKESPEED)) {
         (*gameParameters)[SnakeSpeed]++;
     }
 
@@ -469,8 +1314,8 @@ void collisionDetectFood(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprite
     (*gameParameters)[SnakeScore]++;
 
     // SET FOOD PIECE IN NEW LOCATION
-    randomLocation(ppSprites, gameParameters, &(ppSprites)[0]);
-    updateRect(screen, ppTiles, ppSprites[0], colourFood);
+    randomLocation(ppSprites, gameParameters, &(ppSprites)[food], true);
+    updateRect(screen, ppTiles, ppSprites[food], colourFood);
 
     SDL_Flip(screen);
 }
@@ -577,11 +1422,12 @@ bool scrollSnake(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (
 void updateSnake(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*gameParameters)[9]) {
     int x;
 
-    for (x = (*gameParameters)[NPCCount]; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength]; x++) {
+    // CLEAR THE TILE BEHIND THE TAIL FIRST SO IT NEVER PAINTS OVER A PIECE STACKED ON IT
+    updateRect(screen, ppTiles, ppSprites[(*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 1], colourTiles);
+
+    for (x = (*gameParameters)[NPCCount]; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 1; x++) {
         if (x == (*gameParameters)[NPCCount]) {
             updateRect(screen, ppTiles, ppSprites[x], colourHead);
-        } else if (x == ((*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 1)) {
-            updateRect(screen, ppTiles, ppSprites[x], colourTiles);
         } else if (x == ((*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - 2)) {
             updateRect(screen, ppTiles, ppSprites[x], colourTail);
         } else {
@@ -595,7 +1441,7 @@ void loadNPCs(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*ga
     int x, startNPCs = 0;
 
     for (x = startNPCs; x < (*gameParameters)[NPCCount]; x++) {
-        if (x == startNPCs) {
+        if (x < startNPCs + rules.foodCount) {
             updateRect(screen, ppTiles, ppSprites[x], colourFood);
         } else {
             updateRect(screen, ppTiles, ppSprites[x], colourBlock);
@@ -603,29 +1449,77 @@ void loadNPCs(SDL_Surface* screen, SDL_Rect** ppTiles, int** ppSprites, int (*ga
     }
 }
 
+// WHETHER AN NPC CAN GO ON A TILE: NOT ON ANOTHER SPRITE OR RIGHT NEXT TO THE SNAKE'S HEAD
+bool locationAcceptable(int** ppSprites, int (*gameParameters)[9], int location[2]) {
+    int x;
+
+    // DON'T LOAD NPCs ONTO SNAKE OR OTHER NPCs
+    for (x = 0; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength]; ++x) {
+        if (((ppSprites[x][0]) == location[0]) && ((ppSprites[x][1]) == location[1])) {
+            return false;
+        }
+    }
+
+    // DON'T LOAD NPCs DIRECTLY NEXT TO THE SNAKE'S HEAD
+    if (((((ppSprites[(*gameParameters)[NPCCount]][0]) - 1) == location[0]) && (((ppSprites[(*gameParameters)[NPCCount]][1])) == location[1])) || // ABOVE THE SNAKE'S HEAD
+        ((((ppSprites[(*gameParameters)[NPCCount]][0]) + 1) == location[0]) && (((ppSprites[(*gameParameters)[NPCCount]][1])) == location[1])) || // BELOW THE SNAKE'S HEAD
+        ((((ppSprites[(*gameParameters)[NPCCount]][0])) == location[0]) && (((ppSprites[(*gameParameters)[NPCCount]][1]) - 1) == location[1])) || // LEFT OF THE SNAKE'S HEAD
+        ((((ppSprites[(*gameParameters)[NPCCount]][0])) == location[0]) && (((ppSprites[(*gameParameters)[NPCCount]][1]) + 1) == location[1]))) { // RIGHT OF THE SNAKE'S HEAD
+
+        return false;
+    }
+
+    return true;
+}
+
+// SETS THE SNAKE, THE CURRENT LEVEL'S BLOCKS AND THE FOOD IN THEIR STARTING LOCATIONS
+void placeSprites(int** ppSprites, int (*gameParameters)[9]) {
+    int x;
+
+    // SET SNAKE START POSITION
+    for (x = (*gameParameters)[NPCCount]; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength]; x++) {
+        ppSprites[x][0] = 3;
+        ppSprites[x][1] = (3 + (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength] - DEFAULT_SNAKELENGTH + 2 - x);
+    }
+
+    // SET BLOCK LOCATIONS
+    for (x = 0; x < currentLevel.blockCount; x++) {
+        ppSprites[rules.foodCount + x][0] = currentLevel.blocks[x][0];
+        ppSprites[rules.foodCount + x][1] = currentLevel.blocks[x][1];
+    }
+
+    // TRACK WHICH TILES ARE REACHABLE, THEN SET THE FOOD WHERE THE SNAKE CAN GET TO IT
+    reachReset(ppSprites, gameParameters);
+
+    for (x = 0; x < rules.foodCount; x++) {
+        randomLocation(ppSprites, gameParameters, &(ppSprites)[x], true);
+    }
+}
+
 // A HELPER FUNCTION TO RANDOMLY PLACE NPCs WITH SOME INTELLIGENCE
-void randomLocation(int** ppSprites, int (*gameParameters)[9], int* location[2]) {
-    int x, randLocation[2];
+void randomLocation(int** ppSprites, int (*gameParameters)[9], int* location[2], bool mustBeReachable) {
+    int attempts = 0, randLocation[2];
     bool isAcceptable = false;
 
     while (!isAcceptable) {
-        isAcceptable = true;
-        randLocation[0] = (rand() % ((*gameParameters)[TilesHigh] - 2)) + 1;
-        randLocation[1] = (rand() % ((*gameParameters)[TilesWide] - 2)) + 1;
+        attempts++;
 
-        // DON'T LOAD NPCs ONTO SNAKE OR OTHER NPCs
-        for (x = 0; x < (*gameParameters)[NPCCount] + (*gameParameters)[SnakeLength]; ++x) {
-            if (((ppSprites[x][0]) == randLocation[0]) && ((ppSprites[x][1]) == randLocation[1])) {
-                isAcceptable = false;
+        if (mustBeReachable && (attempts > MAX_PLACEMENT_ATTEMPTS)) {
+            // RANDOM TRIES KEEP LANDING OUT OF REACH, SO PICK STRAIGHT FROM THE TILES THE SNAKE CAN GET TO
+            if (reachRandomLocation(ppSprites, gameParameters, randLocation)) {
+                break;
             }
+
+            // THE SNAKE'S AREAS HAVE NO ACCEPTABLE TILE LEFT, SO ANY FREE TILE WILL HAVE TO DO
+            mustBeReachable = false;
         }
 
-        // DON'T LOAD NPCs DIRECTLY NEXT TO THE SNAKE'S HEAD
-        if (((((ppSprites[(*gameParameters)[NPCCount]][0]) - 1) == randLocation[0]) && (((ppSprites[(*gameParameters)[NPCCount]][1])) == randLocation[1])) || // ABOVE THE SNAKE'S HEAD
-            ((((ppSprites[(*gameParameters)[NPCCount]][0]) + 1) == randLocation[0]) && (((ppSprites[(*gameParameters)[NPCCount]][1])) == randLocation[1])) || // BELOW THE SNAKE'S HEAD
-            ((((ppSprites[(*gameParameters)[NPCCount]][0])) == randLocation[0]) && (((ppSprites[(*gameParameters)[NPCCount]][1]) - 1) == randLocation[1])) || // LEFT OF THE SNAKE'S HEAD
-            ((((ppSprites[(*gameParameters)[NPCCount]][0])) == randLocation[0]) && (((ppSprites[(*gameParameters)[NPCCount]][1]) + 1) == randLocation[1]))) { // RIGHT OF THE SNAKE'S HEAD
+        randLocation[0] = (rand() % ((*gameParameters)[TilesHigh] - 2)) + 1;
+        randLocation[1] = (rand() % ((*gameParameters)[TilesWide] - 2)) + 1;
+        isAcceptable = locationAcceptable(ppSprites, gameParameters, randLocation);
 
+        // DON'T LOAD NPCs SOMEWHERE THE SNAKE CAN'T GET TO
+        if (isAcceptable && mustBeReachable && !reachFromHead(ppSprites, gameParameters, randLocation)) {
             isAcceptable = false;
         }
     }
@@ -663,7 +1557,20 @@ void updateRect(SDL_Surface* screen, SDL_Rect** ppTiles, int position[2], const
 
 // PARSES COMMANDLINE OPTIONS AND GENERATES APPROPRIATE RESPONSE
 void configureGame(int argc, char** args, int (*gameParameters)[9]) {
-    int parsecount = 1;
+    int x, parsecount = 1, packNumber = 0;
+    char* packFilename = NULL;
+    bool writePack = false;
+
+    // SET DEFAULT RULES
+    rules.wrapWalls = false;
+    rules.growthPerFood = DEFAULT_GROWTH;
+    rules.accelFreq = DEFAULT_ACCELFREQ;
+    rules.foodCount = DEFAULT_FOODCOUNT;
+    rules.blockPattern = BlocksRandom;
+
+    for (x = MIN_SNAKESPEED; x <= MAX_SNAKESPEED; x++) {
+        rules.tickDelay[x] = 250 / (x + 3);
+    }
 
     // SET DEFAULT GAME PARAMETERS
     (*gameParameters)[QuitGame] = 0;
@@ -739,6 +1646,32 @@ void configureGame(int argc, char** args, int (*gameParameters)[9]) {
                 printErrorHelp(args[0]);
                 exit(EXIT_FAILURE);
             }
+        } else if (strcmp(args[parsecount], "-c") == 0) {
+            // RULES FILE
+            if ((parsecount + 1) < argc) {
+                loadRules(args[parsecount + 1]);
+                parsecount = parsecount + 2;
+            } else {
+                printErrorHelp(args[0]);
+                exit(EXIT_FAILURE);
+            }
+        } else if ((strcmp(args[parsecount], "-p") == 0) || (strcmp(args[parsecount], "-w") == 0)) {
+            // LEVEL PACK TO PLAY FROM OR WRITE TO
+            if ((parsecount + 2) < argc) {
+                writePack = (strcmp(args[parsecount], "-w") == 0);
+                packFilename = args[parsecount + 1];
+                packNumber = atoi(args[parsecount + 2]); // The level to play, or how many to write
+
+                if (writePack && ((packNumber < 1) || (packNumber > MAX_LEVELPACKSIZE))) {
+                    printErrorHelp(args[0]);
+                    exit(EXIT_FAILURE);
+                }
+
+                parsecount = parsecount + 3;
+            } else {
+                printErrorHelp(args[0]);
+                exit(EXIT_FAILURE);
+            }
         } else if (strcmp(args[parsecount], "-2") == 0) {
             // DOUBLE RESOLUTION
             (*gameParameters)[RenderSizeMultiplier] = 2;
@@ -749,6 +1682,118 @@ void configureGame(int argc, char** args, int (*gameParameters)[9]) {
             exit(EXIT_FAILURE);
         }
     }
+
+    // EVERY PIECE OF FOOD AFTER THE FIRST TAKES AN EXTRA NPC
+    (*gameParameters)[NPCCount] += rules.foodCount - 1;
+
+    if (packFilename != NULL) {
+        if (writePack) {
+            // GENERATE THE LEVEL PACK AND QUIT
+            writeLevelPack(packFilename, packNumber, gameParameters);
+            exit(EXIT_SUCCESS);
+        }
+
+        // PLAY ON THE LEVEL PACK'S GRID
+        openLevelPack(packFilename, packNumber);
+        (*gameParameters)[TilesWide] = pack.tilesWide;
+        (*gameParameters)[TilesHigh] = pack.tilesHigh;
+    }
+}
+
+// READS A NUMBER FROM THE START OF A RULE VALUE AND MOVES PAST IT, FAILING IF THERE ISN'T ONE IN RANGE
+static bool readRuleNumber(char** value, int minimum, int maximum, int* number) {
+    char* end;
+    long parsed = strtol(*value, &end, 10);
+
+    if ((end == *value) || (parsed < minimum) || (parsed > maximum)) {
+        return false;
+    }
+
+    *number = (int)parsed;
+    *value = end;
+    return true;
+}
+
+// PARSES A RULES FILE OF "key = value" LINES INTO THE RULE TABLE
+void loadRules(char* filename) {
+    FILE* file;
+    char line[MAX_RULESLINE], key[MAX_RULESLINE], value[MAX_RULESLINE];
+    char *comment, *cursor;
+    int x, linecount = 0, delays[MAX_SNAKESPEED];
+    bool isValid;
+
+    if ((file = fopen(filename, "r")) == NULL) {
+        fprintf(stderr, "  Error: unable to open rules file %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        linecount++;
+
+        // A # STARTS A COMMENT ANYWHERE ON THE LINE, AND TRAILING WHITESPACE ISN'T PART OF THE VALUE
+        if ((comment = strchr(line, '#')) != NULL) {
+            *comment = '\0';
+        }
+
+        for (x = strlen(line); (x > 0) && isspace((unsigned char)line[x - 1]); x--) {
+            line[x - 1] = '\0';
+        }
+
+        // SKIP LINES THAT WERE BLANK OR ONLY A COMMENT
+        if (sscanf(line, " %s", key) != 1) {
+            continue;
+        }
+
+        isValid = true;
+        cursor = value;
+
+        if (sscanf(line, " %[^= \t] = %[^\r\n]", key, value) != 2) {
+            isValid = false;
+        } else if (strcmp(key, "wrap") == 0) {
+            rules.wrapWalls = (strcmp(value, "yes") == 0);
+            isValid = (rules.wrapWalls || (strcmp(value, "no") == 0));
+        } else if (strcmp(key, "growth") == 0) {
+            isValid = (readRuleNumber(&cursor, MIN_GROWTH, MAX_GROWTH, &rules.growthPerFood) && (*cursor == '\0'));
+        } else if (strcmp(key, "accel") == 0) {
+            isValid = (readRuleNumber(&cursor, MIN_ACCELFREQ, MAX_ACCELFREQ, &rules.accelFreq) && (*cursor == '\0'));
+        } else if (strcmp(key, "food") == 0) {
+            isValid = (readRuleNumber(&cursor, MIN_FOODCOUNT, MAX_FOODCOUNT, &rules.foodCount) && (*cursor == '\0'));
+        } else if (strcmp(key, "blocks") == 0) {
+            if (strcmp(value, "random") == 0) {
+                rules.blockPattern = BlocksRandom;
+            } else if (strcmp(value, "symmetric") == 0) {
+                rules.blockPattern = BlocksSymmetric;
+            } else if (strcmp(value, "maze") == 0) {
+                rules.blockPattern = BlocksMaze;
+            } else if (strcmp(value, "rooms") == 0) {
+                rules.blockPattern = BlocksRooms;
+            } else {
+                isValid = false;
+            }
+        } else if (strcmp(key, "delays") == 0) {
+            // ONE DELAY IN MILLISECONDS FOR EACH SPEED, SLOWEST FIRST
+            for (x = 0; isValid && (x < MAX_SNAKESPEED); x++) {
+                isValid = readRuleNumber(&cursor, MIN_TICKDELAY, MAX_TICKDELAY, &delays[x]);
+            }
+
+            // EXACTLY ONE DELAY PER SPEED
+            isValid = (isValid && (*cursor == '\0'));
+
+            for (x = 0; isValid && (x < MAX_SNAKESPEED); x++) {
+                rules.tickDelay[x + MIN_SNAKESPEED] = delays[x];
+            }
+        } else {
+            isValid = false;
+        }
+
+        if (!isValid) {
+            fprintf(stderr, "  Error: invalid rule on line %d of %s\n", linecount, filename);
+            fclose(file);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fclose(file);
 }
 
 // PRINT THE HELP MENU TO THE COMMANDLINE
@@ -759,6 +1804,9 @@ void printHelpMenu(char filename[]) {
     fprintf(stdout, "    -b [blocks]\t\tSet the number of blocks: between [%d] and [%d] (DEFAULT: [%d])\n", MIN_NPCCOUNT - 1, MAX_NPCCOUNT - 1, DEFAULT_NPCCOUNT - 1);
     fprintf(stdout, "    -l [length]\t\tSet the snake's starting length: between [%d] and [%d] (DEFAULT: [%d])\n", MIN_SNAKELENGTH - 1, MAX_SNAKELENGTH - 1, DEFAULT_SNAKELENGTH - 1);
     fprintf(stdout, "    -s [speed]\t\tSet the snake's starting speed: between [%d] and [%d] (DEFAULT: [%d])\n", MIN_SNAKESPEED, MAX_SNAKESPEED, DEFAULT_SNAKESPEED);
+    fprintf(stdout, "    -c [rules]\t\tLoad a rule set from a rules file\n");
+    fprintf(stdout, "    -p [pack] [level]\tPlay a level from a level pack\n");
+    fprintf(stdout, "    -w [pack] [levels]\tGenerate a level pack with the current settings and quit\n");
     fprintf(stdout, "    -2\t\t\tDouble the size the game renders at\n");
     fprintf(stdout, "    -h\t\t\tDisplay help information\n");
 }